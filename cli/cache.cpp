@@ -0,0 +1,94 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "cache.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <louvre/include.hpp>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace louvre::cli {
+std::optional<Response>
+OutputCache::find(const std::string              &key,
+                  std::filesystem::file_time_type time,
+                  IncludeCache                   &includes) {
+    auto it = this->mEntries.find(key);
+
+    if (this->mEntries.end() == it) {
+        return std::nullopt;
+    }
+
+    const Cached &cached = it->second.mCached;
+
+    if (time != cached.mTime ||
+        !std::all_of(cached.mIncludes.begin(),
+                     cached.mIncludes.end(),
+                     [&](const auto &include) {
+                         return include.second ==
+                                includes.version(include.first);
+                     })) {
+        this->erase(key);
+        return std::nullopt;
+    }
+
+    this->mUses.splice(this->mUses.begin(), this->mUses, it->second.mUse);
+    return cached.mResponse;
+}
+
+void OutputCache::insert(const std::string &key, Cached cached) {
+    this->erase(key);
+    const std::size_t size = OutputCache::cost(key, cached);
+
+    if (size > this->mBudget) {
+        return;
+    }
+
+    while (this->mSize + size > this->mBudget) {
+        this->erase(std::string(this->mUses.back()));
+    }
+
+    this->mUses.push_front(key);
+    this->mEntries.emplace(key, Entry{std::move(cached), this->mUses.begin()});
+    this->mSize += size;
+}
+
+std::size_t OutputCache::cost(const std::string &key, const Cached &cached) {
+    std::size_t size =
+        sizeof(Entry) + 2 * key.size() + cached.mResponse.mBody.size();
+
+    for (const auto &include : cached.mIncludes) {
+        size += sizeof(include) + include.first.size();
+    }
+
+    return size;
+}
+
+void OutputCache::erase(const std::string &key) {
+    auto it = this->mEntries.find(key);
+
+    if (this->mEntries.end() == it) {
+        return;
+    }
+
+    this->mSize -= OutputCache::cost(key, it->second.mCached);
+    this->mUses.erase(it->second.mUse);
+    this->mEntries.erase(it);
+}
+
+} // namespace louvre::cli
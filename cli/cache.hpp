@@ -0,0 +1,80 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include "protocol.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <list>
+#include <louvre/include.hpp>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace louvre::cli {
+// Response to a file converted before, valid while the file has the same
+// modification time and every file it includes the same cached version
+class Cached {
+    public:
+    std::filesystem::file_time_type                  mTime;
+    std::vector<std::pair<std::string, std::size_t>> mIncludes;
+    Response                                         mResponse;
+};
+
+// Cached responses by key, evicting the least recently used ones once they
+// take more memory than the budget. Not thread safe
+class OutputCache {
+    private:
+    class Entry {
+        public:
+        Cached                           mCached;
+        std::list<std::string>::iterator mUse;
+    };
+
+    const std::size_t                      mBudget;
+    std::size_t                            mSize;
+    std::list<std::string>                 mUses;
+    std::unordered_map<std::string, Entry> mEntries;
+
+    public:
+    OutputCache(std::size_t budget) : mBudget(budget), mSize(0) {};
+
+    // The response cached for a file last written at time, unless the file
+    // or one of its includes changed since. Stale responses are dropped
+    std::optional<Response> find(const std::string              &key,
+                                 std::filesystem::file_time_type time,
+                                 IncludeCache                   &includes);
+
+    // Responses larger than the whole budget are not cached
+    void insert(const std::string &key, Cached cached);
+
+    inline std::size_t size() const {
+        return this->mSize;
+    }
+
+    inline std::size_t count() const {
+        return this->mEntries.size();
+    }
+
+    private:
+    static std::size_t cost(const std::string &key, const Cached &cached);
+    void               erase(const std::string &key);
+};
+
+} // namespace louvre::cli
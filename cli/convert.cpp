@@ -0,0 +1,98 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "convert.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <louvre/api.hpp>
+#include <louvre/text.hpp>
+#include <memory>
+#include <optional>
+#include <string>
+#include <variant>
+
+namespace louvre::cli {
+static std::string render_text(std::shared_ptr<Node> root, std::size_t width) {
+    return TextEmitter(width).emit(root);
+}
+
+static const Format FORMATS[] = {
+    {"text", ".txt", render_text},
+};
+
+static std::string describe(const SourceLocation &location,
+                            const std::string    &message) {
+    return location.path() + ":" + std::to_string(location.line() + 1) + ":" +
+           std::to_string(location.column() + 1) + ": " + message;
+}
+
+const std::optional<Format> Converter::find_format(const std::string &name) {
+    for (const auto &format : FORMATS) {
+        if (name == format.mName) {
+            return format;
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::variant<Conversion, ConversionError>
+Converter::convert(std::string source, const std::string &path) const {
+    auto parser = Parser(std::move(source), path);
+    parser.set_include_cache(this->mIncludes);
+
+    for (const auto &[limit, value] : this->mBounds.mLimits) {
+        parser.set_limit(limit, value);
+    }
+
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    if (this->mBounds.mTimeout) {
+        deadline = std::chrono::steady_clock::now() + *this->mBounds.mTimeout;
+    }
+
+    auto res = parser.parse(deadline);
+
+    if (const auto e = std::get_if<SyntaxError>(&res)) {
+        return ConversionError(describe(e->location(), e->message()));
+    }
+
+    if (const auto e = std::get_if<TagError>(&res)) {
+        return ConversionError(describe(e->tag()->location(),
+                                        e->message() + " (#" +
+                                            e->tag()->name() + ")"));
+    }
+
+    if (const auto e = std::get_if<NodeError>(&res)) {
+        const auto tag = e->node()->tag();
+        return ConversionError(
+            tag ? describe((*tag)->location(), e->message())
+                : path + ": " + e->message());
+    }
+
+    if (const auto e = std::get_if<CancelledError>(&res)) {
+        return ConversionError(describe(e->location(), "Timed out"));
+    }
+
+    if (const auto e = std::get_if<LimitError>(&res)) {
+        return ConversionError(describe(e->location(), e->message()));
+    }
+
+    return Conversion{this->mFormat.mRender(
+                          std::get<std::shared_ptr<Node>>(res), this->mWidth),
+                      parser.included_files()};
+}
+
+} // namespace louvre::cli
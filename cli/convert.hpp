@@ -0,0 +1,101 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <louvre/api.hpp>
+#include <louvre/include.hpp>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace louvre::cli {
+class ConversionError {
+    private:
+    const std::string mMessage;
+
+    public:
+    ConversionError(std::string message) : mMessage(message) {};
+
+    inline const std::string message() const {
+        return this->mMessage;
+    }
+};
+
+class Conversion {
+    public:
+    std::string              mOutput;
+    std::vector<std::string> mIncludes;
+};
+
+// An output format: the extension of its files and the function that
+// renders a tree in the format
+class Format {
+    public:
+    const char *mName;
+    const char *mExtension;
+    std::string (*mRender)(std::shared_ptr<Node> root, std::size_t width);
+};
+
+// Limits and time allowed for each conversion, for documents that cannot be
+// trusted. Limits that are not listed are not checked
+class Bounds {
+    public:
+    std::map<Limit, std::size_t>             mLimits;
+    std::optional<std::chrono::milliseconds> mTimeout;
+};
+
+// Parses and renders documents. Included files are parsed once and shared
+// by all conversions, which may run on any number of threads. Converters to
+// different formats can share the same include cache
+class Converter {
+    private:
+    const Format                  mFormat;
+    const std::size_t             mWidth;
+    std::shared_ptr<IncludeCache> mIncludes;
+    const Bounds                  mBounds;
+
+    public:
+    Converter(const Format                 &format,
+              std::size_t                   width,
+              std::shared_ptr<IncludeCache> includes =
+                  std::make_shared<IncludeCache>(),
+              Bounds                        bounds = Bounds())
+        : mFormat(format), mWidth(width), mIncludes(includes),
+          mBounds(std::move(bounds)) {};
+
+    static const std::optional<Format> find_format(const std::string &name);
+
+    inline const Format &format() const {
+        return this->mFormat;
+    }
+
+    inline const std::shared_ptr<IncludeCache> &includes() const {
+        return this->mIncludes;
+    }
+
+    // The path is used to resolve #include and to report errors. The
+    // conversion lists the files included directly by the document
+    std::variant<Conversion, ConversionError>
+    convert(std::string source, const std::string &path) const;
+};
+
+} // namespace louvre::cli
@@ -0,0 +1,402 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "cache.hpp"
+#include "convert.hpp"
+#include "protocol.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <louvre/api.hpp>
+#include <louvre/include.hpp>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace louvre::cli {
+static const char *const USAGE =
+    "Usage: louvred [options]\n"
+    "\n"
+    "Converts documents for louvre commands run with --socket, keeping\n"
+    "included files and outputs cached between requests.\n"
+    "\n"
+    "Options:\n"
+    "  -s, --socket <path>      Socket to listen on,\n"
+    "                           $XDG_RUNTIME_DIR/louvred.sock by default\n"
+    "  -j, --jobs <count>       Requests converted at once, one per core by\n"
+    "                           default\n"
+    "  -m, --max-size <MiB>     Largest path, source or output accepted in a\n"
+    "                           request, 256 MiB by default\n"
+    "  -c, --cache <MiB>        Memory for cached outputs, 512 MiB by default\n"
+    "  -n, --max-nodes <count>  Nodes allowed in a document, macro expansions\n"
+    "                           included, 1000000 by default\n"
+    "  -M, --max-memory <MiB>   Memory allowed to parse a document, 1024 MiB\n"
+    "                           by default\n"
+    "  -t, --timeout <ms>       Time allowed for a conversion, 10000 ms by\n"
+    "                           default\n"
+    "  -i, --idle <seconds>     Time before idle connections are closed, 30 s\n"
+    "                           by default\n"
+    "  -q, --quiet              Do not print the socket path\n"
+    "  -h, --help               Print this message\n"
+    "\n"
+    "Limits set to 0 are not checked.\n";
+
+// Options of the daemon. Documents sent to it may come from anywhere, so
+// they are parsed within bounds unless told otherwise. Nesting is always
+// limited, since trees are rendered recursively
+class Settings {
+    public:
+    std::string mSocket    = default_socket();
+    std::size_t mThreads   = 0;
+    std::size_t mMaxField  = Channel::MAX_FIELD;
+    std::size_t mCacheSize = std::size_t(512) << 20;
+    std::size_t mIdle      = 30;
+    Bounds      mBounds    = {{{Limit::Depth, 256},
+                               {Limit::Nodes, 1000000},
+                               {Limit::Memory, std::size_t(1024) << 20}},
+                              std::chrono::milliseconds(10000)};
+    bool        mQuiet     = false;
+};
+
+// Widest text accepted, so that clients cannot make a converter for every
+// width they send
+static constexpr std::size_t MAX_WIDTH = 1024;
+
+static bool is_count(const std::string &arg) {
+    return !arg.empty() && std::all_of(arg.begin(), arg.end(), [](char c) {
+        return '0' <= c && c <= '9';
+    });
+}
+
+// Path of the socket, removed when the daemon is stopped by a signal
+static char socket_path[sizeof(sockaddr_un::sun_path)];
+
+static void stop(int) {
+    ::unlink(socket_path);
+    ::_exit(0);
+}
+
+// Answers requests on a fixed number of threads, each of which accepts a
+// connection and serves it until the client closes it or stays idle for too
+// long, so that idle clients cannot hold every thread. Converters and
+// cached outputs are shared by all threads, and so is the include cache.
+// Outputs are cached within a memory budget
+class Daemon {
+    private:
+    using Key = std::pair<std::string, std::size_t>;
+
+    const int                                 mListener;
+    const Settings                            mSettings;
+    const std::shared_ptr<IncludeCache>       mIncludes;
+    std::mutex                                mMutex;
+    std::map<Key, std::unique_ptr<Converter>> mConverters;
+    OutputCache                               mOutputs;
+
+    public:
+    Daemon(int listener, const Settings &settings)
+        : mListener(listener), mSettings(settings),
+          mIncludes(std::make_shared<IncludeCache>()),
+          mOutputs(settings.mCacheSize) {};
+
+    void serve(std::size_t threads) {
+        std::vector<std::thread> workers;
+
+        for (std::size_t i = 0; i < threads; i++) {
+            workers.emplace_back([this]() {
+                while (true) {
+                    const int fd = ::accept(this->mListener, nullptr, nullptr);
+
+                    if (fd < 0) {
+                        continue;
+                    }
+
+                    // Reads and writes fail once they wait for that long
+                    if (0 < this->mSettings.mIdle) {
+                        timeval idle = {};
+                        idle.tv_sec  = this->mSettings.mIdle;
+                        ::setsockopt(
+                            fd, SOL_SOCKET, SO_RCVTIMEO, &idle, sizeof(idle));
+                        ::setsockopt(
+                            fd, SOL_SOCKET, SO_SNDTIMEO, &idle, sizeof(idle));
+                    }
+
+                    // A failure only drops the connection that caused it
+                    try {
+                        Channel channel(fd, this->mSettings.mMaxField);
+                        while (const auto request = channel.receive_request()) {
+                            if (!channel.send(this->answer(*request))) {
+                                break;
+                            }
+                        }
+                    } catch (const std::exception &e) {
+                        std::fprintf(stderr, "louvred: %s\n", e.what());
+                    }
+                }
+            });
+        }
+
+        for (auto &worker : workers) {
+            worker.join();
+        }
+    }
+
+    private:
+    // Unknown formats are not stored, so that they do not fill the map
+    const Converter *converter(const std::string &format, std::size_t width) {
+        std::lock_guard<std::mutex> lock(this->mMutex);
+        const Key                   key(format, width);
+        auto                        it = this->mConverters.find(key);
+
+        if (this->mConverters.end() != it) {
+            return it->second.get();
+        }
+
+        const auto found = Converter::find_format(format);
+
+        if (!found) {
+            return nullptr;
+        }
+
+        auto converter = std::make_unique<Converter>(
+            *found, width, this->mIncludes, this->mSettings.mBounds);
+        return this->mConverters.emplace(key, std::move(converter))
+            .first->second.get();
+    }
+
+    Response answer(const Request &request) {
+        if (0 == request.mWidth || request.mWidth > MAX_WIDTH) {
+            return Response{
+                true, 0, "invalid width " + std::to_string(request.mWidth)};
+        }
+
+        const Converter *converter =
+            this->converter(request.mFormat, request.mWidth);
+
+        if (nullptr == converter) {
+            return Response{true, 0, "unknown format " + request.mFormat};
+        }
+
+        if (request.mSource) {
+            auto res = converter->convert(*request.mSource, request.mPath);
+
+            if (const auto e = std::get_if<ConversionError>(&res)) {
+                return Response{true, request.mSource->size(), e->message()};
+            }
+
+            return Response{false,
+                            request.mSource->size(),
+                            std::move(std::get<Conversion>(res).mOutput)};
+        }
+
+        const std::string key = request.mFormat + '\0' +
+                                std::to_string(request.mWidth) + '\0' +
+                                request.mPath;
+
+        std::error_code ec;
+        const auto time = std::filesystem::last_write_time(request.mPath, ec);
+
+        if (ec || !std::filesystem::path(request.mPath).is_absolute()) {
+            return Response{true, 0, request.mPath + ": cannot read file"};
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(this->mMutex);
+            auto cached = this->mOutputs.find(key, time, *this->mIncludes);
+
+            if (cached) {
+                return *cached;
+            }
+        }
+
+        std::ifstream file(request.mPath, std::ios::binary);
+        std::string   source((std::istreambuf_iterator<char>(file)),
+                           std::istreambuf_iterator<char>());
+
+        if (!file.good() && !file.eof()) {
+            return Response{true, 0, request.mPath + ": cannot read file"};
+        }
+
+        const std::size_t bytes_in = source.size();
+        auto              res      = converter->convert(std::move(source),
+                                          request.mPath);
+
+        // Failures are not cached, since they do not list the files they
+        // include
+        if (const auto e = std::get_if<ConversionError>(&res)) {
+            return Response{true, bytes_in, e->message()};
+        }
+
+        auto  &conversion = std::get<Conversion>(res);
+        Cached cached{time, {}, {false, bytes_in, conversion.mOutput}};
+
+        for (const auto &include : conversion.mIncludes) {
+            const auto version = this->mIncludes->version(include);
+
+            if (!version) {
+                return cached.mResponse;
+            }
+
+            cached.mIncludes.push_back(std::make_pair(include, *version));
+        }
+
+        Response                    response = cached.mResponse;
+        std::lock_guard<std::mutex> lock(this->mMutex);
+        this->mOutputs.insert(key, std::move(cached));
+        return response;
+    }
+};
+
+static int run(Settings settings) {
+    const std::string &socket = settings.mSocket;
+
+    // Another daemon may already listen on the socket, otherwise the file
+    // is left over from a daemon that did not exit cleanly
+    if (Channel::connect(socket)) {
+        std::cerr << "louvred: already running on " << socket << std::endl;
+        return 1;
+    }
+
+    if (socket.size() >= sizeof(socket_path)) {
+        std::cerr << "louvred: socket path too long" << std::endl;
+        return 2;
+    }
+
+    ::unlink(socket.c_str());
+
+    sockaddr_un address = {};
+    address.sun_family  = AF_UNIX;
+    std::memcpy(address.sun_path, socket.c_str(), socket.size() + 1);
+
+    const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (listener < 0 ||
+        0 != ::bind(listener,
+                    reinterpret_cast<const sockaddr *>(&address),
+                    sizeof(address)) ||
+        0 != ::listen(listener, SOMAXCONN)) {
+        std::perror(("louvred: " + socket).c_str());
+        return 1;
+    }
+
+    std::memcpy(socket_path, socket.c_str(), socket.size() + 1);
+    std::signal(SIGINT, stop);
+    std::signal(SIGTERM, stop);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    if (0 == settings.mThreads) {
+        settings.mThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    if (!settings.mQuiet) {
+        std::fprintf(stderr,
+                     "louvred: listening on %s with %zu threads\n",
+                     socket.c_str(),
+                     settings.mThreads);
+    }
+
+    Daemon(listener, settings).serve(settings.mThreads);
+    return 0;
+}
+
+// Sizes are given in MiB, and saturate instead of overflowing
+static std::size_t mib(const char *arg) {
+    const std::size_t value = std::strtoul(arg, nullptr, 10);
+    return std::min<std::size_t>(value, SIZE_MAX >> 20) << 20;
+}
+
+// A limit of 0 is not checked
+static void set_bound(Bounds &bounds, Limit limit, std::size_t value) {
+    if (0 == value) {
+        bounds.mLimits.erase(limit);
+    } else {
+        bounds.mLimits[limit] = value;
+    }
+}
+
+// Returns the exit code instead once the usage has been printed
+static std::variant<Settings, int> parse_arguments(int argc, char *argv[]) {
+    Settings settings;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg   = argv[i];
+        const bool        count = i + 1 < argc && is_count(argv[i + 1]);
+
+        if ("-q" == arg || "--quiet" == arg) {
+            settings.mQuiet = true;
+        } else if (("-s" == arg || "--socket" == arg) && i + 1 < argc) {
+            settings.mSocket = argv[++i];
+        } else if (("-j" == arg || "--jobs" == arg) && count) {
+            settings.mThreads = std::strtoul(argv[++i], nullptr, 10);
+        } else if (("-m" == arg || "--max-size" == arg) && count) {
+            settings.mMaxField = mib(argv[++i]);
+        } else if (("-c" == arg || "--cache" == arg) && count) {
+            settings.mCacheSize = mib(argv[++i]);
+        } else if (("-i" == arg || "--idle" == arg) && count) {
+            settings.mIdle = std::strtoul(argv[++i], nullptr, 10);
+        } else if (("-n" == arg || "--max-nodes" == arg) && count) {
+            set_bound(settings.mBounds,
+                      Limit::Nodes,
+                      std::strtoul(argv[++i], nullptr, 10));
+        } else if (("-M" == arg || "--max-memory" == arg) && count) {
+            set_bound(settings.mBounds, Limit::Memory, mib(argv[++i]));
+        } else if (("-t" == arg || "--timeout" == arg) && count) {
+            const std::size_t ms = std::strtoul(argv[++i], nullptr, 10);
+            settings.mBounds.mTimeout =
+                (0 == ms) ? std::nullopt
+                          : std::make_optional(std::chrono::milliseconds(ms));
+        } else {
+            std::cerr << USAGE;
+            return ("-h" == arg || "--help" == arg) ? 0 : 2;
+        }
+    }
+
+    return settings;
+}
+
+} // namespace louvre::cli
+
+int main(int argc, char *argv[]) {
+    const auto settings = louvre::cli::parse_arguments(argc, argv);
+
+    if (const auto code = std::get_if<int>(&settings)) {
+        return *code;
+    }
+
+    return louvre::cli::run(std::get<louvre::cli::Settings>(settings));
+}
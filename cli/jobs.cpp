@@ -0,0 +1,248 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "jobs.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <louvre/loader.hpp>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace louvre::cli {
+std::string canonical_path(const std::filesystem::path &path) {
+    std::error_code ec;
+    const auto      canonical = std::filesystem::weakly_canonical(path, ec);
+    return ec ? path.lexically_normal().string() : canonical.string();
+}
+
+static std::string output_path(const std::filesystem::path &input,
+                               const Format                &format) {
+    return std::filesystem::path(input)
+        .replace_extension(format.mExtension)
+        .string();
+}
+
+static std::variant<std::vector<Job>, std::string>
+find_jobs(const Options &options, const Format &format) {
+    namespace fs = std::filesystem;
+
+    std::vector<Job> jobs;
+    std::error_code  ec;
+
+    // A single file goes to stdout, or to the output path unless it is a
+    // directory
+    if (1 == options.mInputs.size() &&
+        !fs::is_directory(options.mInputs.front(), ec)) {
+        if (!options.mOutput) {
+            return std::vector<Job>{
+                {options.mInputs.front(), std::nullopt, {}, false}};
+        }
+
+        if (!fs::is_directory(*options.mOutput, ec)) {
+            return std::vector<Job>{
+                {options.mInputs.front(), options.mOutput, {}, false}};
+        }
+    }
+
+    for (const auto &input : options.mInputs) {
+        if (!fs::is_directory(input, ec)) {
+            const fs::path name = fs::path(input).filename();
+            jobs.push_back(Job{
+                input,
+                output_path(options.mOutput ? *options.mOutput / name
+                                            : fs::path(input),
+                            format),
+                {},
+                false});
+            continue;
+        }
+
+        fs::recursive_directory_iterator it(input, ec), end;
+
+        if (ec) {
+            return input + ": " + ec.message();
+        }
+
+        for (; it != end; it.increment(ec)) {
+            if (ec) {
+                return input + ": " + ec.message();
+            }
+
+            if (!it->is_regular_file(ec) ||
+                options.mExtension != it->path().extension()) {
+                continue;
+            }
+
+            const fs::path relative = fs::relative(it->path(), input, ec);
+            jobs.push_back(Job{
+                it->path().string(),
+                output_path(options.mOutput ? *options.mOutput / relative
+                                            : it->path(),
+                            format),
+                {},
+                false});
+        }
+    }
+
+    return jobs;
+}
+
+// Outputs that would overwrite an input, or the output of another input, are
+// rejected before anything is converted
+static std::optional<std::string> check_outputs(const std::vector<Job> &jobs) {
+    std::unordered_set<std::string>              inputs;
+    std::unordered_map<std::string, std::string> outputs;
+
+    for (const auto &job : jobs) {
+        inputs.insert(canonical_path(job.mInput));
+    }
+
+    for (const auto &job : jobs) {
+        if (!job.mOutput) {
+            continue;
+        }
+
+        const std::string output = canonical_path(*job.mOutput);
+        const std::string input  = canonical_path(job.mInput);
+
+        if (inputs.contains(output)) {
+            return *job.mOutput + ": output would overwrite an input";
+        }
+
+        // The same input may be given twice
+        const auto [it, inserted] = outputs.emplace(output, input);
+        if (!inserted && input != it->second) {
+            return *job.mOutput + ": output of both " + it->second + " and " +
+                   input;
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::variant<std::vector<Job>, std::string>
+collect_jobs(const Options &options, const Format &format) {
+    auto res = find_jobs(options, format);
+
+    if (auto jobs = std::get_if<std::vector<Job>>(&res)) {
+        if (const auto e = check_outputs(*jobs)) {
+            return *e;
+        }
+    }
+
+    return res;
+}
+
+// Written with a single call, since outputs are rendered in memory
+bool write_output(const std::optional<std::string> &path,
+                  const std::string                &output) {
+    if (!path) {
+        return output.size() ==
+               std::fwrite(output.data(), 1, output.size(), stdout);
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(
+        std::filesystem::path(*path).parent_path(), ec);
+
+    std::ofstream file(*path, std::ios::binary);
+    file.write(output.data(), output.size());
+    return file.good();
+}
+
+void print_errors(std::vector<std::string> &errors) {
+    std::sort(errors.begin(), errors.end());
+    for (const auto &error : errors) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+    }
+}
+
+Summary convert_jobs(const Converter                &converter,
+                     FileLoader                     &loader,
+                     std::vector<Job>               &jobs,
+                     const std::vector<std::size_t> &indices) {
+    std::vector<std::string>                     paths;
+    std::unordered_map<std::string, std::size_t> by_path;
+    for (const auto index : indices) {
+        if (by_path.emplace(jobs[index].mInput, index).second) {
+            paths.push_back(jobs[index].mInput);
+        }
+    }
+
+    std::atomic<std::size_t> bytes_in  = 0;
+    std::atomic<std::size_t> bytes_out = 0;
+    std::mutex               mutex;
+    std::vector<std::string> errors;
+    const auto               start = std::chrono::steady_clock::now();
+
+    // Each job is only touched by the worker that converts it
+    loader.load(paths,
+                [&](const std::string         &path,
+                    std::optional<std::string> content) {
+                    Job        &job = jobs[by_path.at(path)];
+                    std::string error;
+
+                    if (content) {
+                        bytes_in += content->size();
+                        auto res = converter.convert(std::move(*content), path);
+
+                        if (auto e = std::get_if<ConversionError>(&res)) {
+                            error = e->message();
+                        } else {
+                            auto &conversion = std::get<Conversion>(res);
+                            job.mIncludes    = std::move(conversion.mIncludes);
+
+                            if (write_output(job.mOutput,
+                                             conversion.mOutput)) {
+                                bytes_out += conversion.mOutput.size();
+                            } else {
+                                error = job.mOutput.value_or("stdout") +
+                                        ": cannot write output";
+                            }
+                        }
+                    } else {
+                        error = path + ": cannot read file";
+                    }
+
+                    job.mFailed = !error.empty();
+
+                    if (job.mFailed) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        errors.push_back(std::move(error));
+                    }
+                });
+
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    print_errors(errors);
+    return Summary{
+        paths.size(), errors.size(), bytes_in, bytes_out, elapsed.count()};
+}
+
+} // namespace louvre::cli
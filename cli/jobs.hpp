@@ -0,0 +1,117 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include "convert.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <louvre/loader.hpp>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <variant>
+#include <vector>
+
+namespace louvre::cli {
+class Options {
+    public:
+    std::vector<std::string>   mInputs;
+    std::optional<std::string> mOutput;
+    std::optional<std::string> mSocket;
+    std::string                mFormat    = "text";
+    std::string                mExtension = ".lv";
+    std::size_t                mWidth     = 80;
+    std::size_t                mJobs      = 0;
+    bool                       mQuiet     = false;
+    bool                       mWatch     = false;
+};
+
+// An input and the file its output goes to, or std::nullopt for stdout.
+// mIncludes lists the files included by the input when it was last
+// converted, and mFailed tells whether that conversion failed
+class Job {
+    public:
+    std::string                mInput;
+    std::optional<std::string> mOutput;
+    std::vector<std::string>   mIncludes;
+    bool                       mFailed;
+};
+
+class Summary {
+    public:
+    std::size_t mFiles;
+    std::size_t mFailed;
+    std::size_t mBytesIn;
+    std::size_t mBytesOut;
+    double      mSeconds;
+};
+
+// Lists the jobs for the inputs. Returns an error if an output would
+// overwrite an input or the output of another input
+std::variant<std::vector<Job>, std::string>
+collect_jobs(const Options &options, const Format &format);
+
+// The canonical form of a path that may not exist yet, used to compare paths
+std::string canonical_path(const std::filesystem::path &path);
+
+// Converts the jobs at the given indices, each one as soon as its input has
+// been read, and prints errors in order of input path
+Summary convert_jobs(const Converter                &converter,
+                     FileLoader                     &loader,
+                     std::vector<Job>               &jobs,
+                     const std::vector<std::size_t> &indices);
+
+// Same as convert_jobs(), but asks louvred to convert the jobs over up to
+// the given number of connections. Returns std::nullopt if no daemon
+// listens on the socket
+std::optional<Summary> convert_remote(const std::string              &socket,
+                                      const Format                   &format,
+                                      std::size_t                     width,
+                                      std::size_t                     threads,
+                                      std::vector<Job>               &jobs,
+                                      const std::vector<std::size_t> &indices);
+
+// Writes to stdout if there is no path. Returns false on errors
+bool write_output(const std::optional<std::string> &path,
+                  const std::string                &output);
+
+// Prints the errors of a batch of jobs, sorted by path
+void print_errors(std::vector<std::string> &errors);
+
+// Directories watched for a job whose input has the given canonical path:
+// that of the input and those of every file it includes, directly or not
+std::vector<std::string> watched_directories(const std::string &input,
+                                             const Job         &job,
+                                             IncludeCache      &includes);
+
+// Jobs to convert again once the files in changed were written, given the
+// canonical path of the input of each job. Failed jobs are always included,
+// since a failed conversion does not list the files it includes
+std::vector<std::size_t>
+stale_jobs(const std::vector<Job>                &jobs,
+           const std::vector<std::string>        &inputs,
+           const std::unordered_set<std::string> &changed,
+           IncludeCache                          &includes);
+
+// Watches the inputs and the files they include, converting again the jobs
+// affected by every change. Only returns on errors
+int watch(const Options    &options,
+          const Converter  &converter,
+          FileLoader       &loader,
+          std::vector<Job> &jobs);
+
+} // namespace louvre::cli
@@ -0,0 +1,245 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "convert.hpp"
+#include "jobs.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <louvre/loader.hpp>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <variant>
+#include <vector>
+
+namespace louvre::cli {
+static const char *const USAGE =
+    "Usage: louvre [options] <file or directory>...\n"
+    "\n"
+    "Converts files, and every file with the source extension found in\n"
+    "directories, to the output format.\n"
+    "\n"
+    "Options:\n"
+    "  -o, --output <path>    Output file for a single input, or directory\n"
+    "                         mirroring the inputs. Outputs are written next\n"
+    "                         to their inputs by default, or to stdout for a\n"
+    "                         single file\n"
+    "  -f, --format <name>    Output format: text (default)\n"
+    "  -w, --width <columns>  Line width of text output, 80 by default\n"
+    "  -e, --extension <ext>  Extension of sources in directories, .lv by\n"
+    "                         default\n"
+    "  -j, --jobs <count>     Worker threads, one per core by default\n"
+    "  -s, --socket <path>    Convert through the louvred daemon listening on\n"
+    "                         the socket. The LOUVRE_SOCKET variable sets a\n"
+    "                         default, which is skipped if no daemon listens\n"
+    "  -q, --quiet            Do not print the summary\n"
+    "      --watch            Keep running, and convert inputs again when\n"
+    "                         they or the files they include change\n"
+    "  -h, --help             Print this message\n";
+
+// Rejects anything but digits, and counts too large for std::size_t
+static std::optional<std::size_t> parse_count(const std::string &arg) {
+    const char *const end = arg.data() + arg.size();
+    std::size_t       count;
+    const auto [ptr, ec]  = std::from_chars(arg.data(), end, count);
+
+    if (std::errc() != ec || end != ptr) {
+        return std::nullopt;
+    }
+
+    return count;
+}
+
+static std::variant<Options, std::string> parse_arguments(int   argc,
+                                                          char *argv[]) {
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+
+        if ("-h" == arg || "--help" == arg) {
+            return std::string();
+        }
+
+        if ("-q" == arg || "--quiet" == arg) {
+            options.mQuiet = true;
+            continue;
+        }
+
+        if ("--watch" == arg) {
+            options.mWatch = true;
+            continue;
+        }
+
+        if (!arg.starts_with("-") || "-" == arg) {
+            options.mInputs.push_back(arg);
+            continue;
+        }
+
+        static const std::vector<std::string> with_value = {
+            "-o", "--output", "-f", "--format", "-e", "--extension",
+            "-w", "--width",  "-j", "--jobs",     "-s", "--socket"};
+
+        if (with_value.end() ==
+            std::find(with_value.begin(), with_value.end(), arg)) {
+            return "Unknown option " + arg;
+        }
+
+        if (i + 1 == argc) {
+            return "Missing value for " + arg;
+        }
+
+        const std::string value = argv[++i];
+
+        if ("-o" == arg || "--output" == arg) {
+            options.mOutput = value;
+        } else if ("-s" == arg || "--socket" == arg) {
+            options.mSocket = value;
+        } else if ("-f" == arg || "--format" == arg) {
+            options.mFormat = value;
+        } else if ("-e" == arg || "--extension" == arg) {
+            options.mExtension = value.starts_with(".") ? value : "." + value;
+        } else if ("-w" == arg || "--width" == arg) {
+            const auto width = parse_count(value);
+
+            if (!width || 0 == *width) {
+                return "Invalid width " + value;
+            }
+
+            options.mWidth = *width;
+        } else if ("-j" == arg || "--jobs" == arg) {
+            const auto jobs = parse_count(value);
+
+            if (!jobs) {
+                return "Invalid number of jobs " + value;
+            }
+
+            options.mJobs = *jobs;
+        }
+    }
+
+    if (options.mInputs.empty()) {
+        return std::string("No input files");
+    }
+
+    return options;
+}
+
+static void print_summary(const Options &options, const Summary &summary) {
+    if (options.mQuiet) {
+        return;
+    }
+
+    const double mib = summary.mBytesIn / (1024.0 * 1024.0);
+    std::fprintf(stderr,
+                 "louvre: converted %zu of %zu files, %.2f MiB in %.1f ms "
+                 "(%.1f MiB/s, %.2f MiB written)\n",
+                 summary.mFiles - summary.mFailed,
+                 summary.mFiles,
+                 mib,
+                 summary.mSeconds * 1000,
+                 (summary.mSeconds > 0) ? mib / summary.mSeconds : 0.0,
+                 summary.mBytesOut / (1024.0 * 1024.0));
+}
+
+static int run(const Options &options) {
+    const auto format = Converter::find_format(options.mFormat);
+
+    if (!format) {
+        std::cerr << "louvre: unknown format " << options.mFormat << std::endl;
+        return 2;
+    }
+
+    auto jobs_res = collect_jobs(options, *format);
+
+    if (const auto e = std::get_if<std::string>(&jobs_res)) {
+        std::cerr << "louvre: " << *e << std::endl;
+        return 2;
+    }
+
+    auto &jobs = std::get<std::vector<Job>>(jobs_res);
+
+    if (options.mWatch && 1 == jobs.size() && !jobs.front().mOutput) {
+        std::cerr << "louvre: --watch needs an output file" << std::endl;
+        return 2;
+    }
+
+    if (options.mWatch && options.mSocket) {
+        std::cerr << "louvre: --watch cannot be used with --socket"
+                  << std::endl;
+        return 2;
+    }
+
+    std::vector<std::size_t> indices(jobs.size());
+    for (std::size_t i = 0; i < jobs.size(); i++) {
+        indices[i] = i;
+    }
+
+    // Watch mode keeps its own caches, so it always converts in process
+    std::optional<std::string> socket = options.mSocket;
+    if (const char *env = std::getenv("LOUVRE_SOCKET");
+        !socket && !options.mWatch && nullptr != env && '\0' != *env) {
+        socket = env;
+    }
+
+    if (socket) {
+        const auto summary = convert_remote(
+            *socket, *format, options.mWidth, options.mJobs, jobs, indices);
+
+        if (summary) {
+            print_summary(options, *summary);
+            return (0 == summary->mFailed) ? 0 : 1;
+        }
+
+        if (options.mSocket) {
+            std::cerr << "louvre: no daemon listening on " << *socket
+                      << std::endl;
+            return 2;
+        }
+    }
+
+    const Converter converter(*format, options.mWidth);
+    FileLoader      loader(options.mJobs);
+    const Summary   summary = convert_jobs(converter, loader, jobs, indices);
+    print_summary(options, summary);
+
+    if (options.mWatch) {
+        return watch(options, converter, loader, jobs);
+    }
+
+    return (0 == summary.mFailed) ? 0 : 1;
+}
+
+} // namespace louvre::cli
+
+int main(int argc, char *argv[]) {
+    const auto options = louvre::cli::parse_arguments(argc, argv);
+
+    if (const auto e = std::get_if<std::string>(&options)) {
+        if (!e->empty()) {
+            std::cerr << "louvre: " << *e << "\n\n";
+        }
+
+        std::cerr << louvre::cli::USAGE;
+        return e->empty() ? 0 : 2;
+    }
+
+    return louvre::cli::run(std::get<louvre::cli::Options>(options));
+}
@@ -0,0 +1,248 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "protocol.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace louvre::cli {
+// Longest header line accepted, well above any valid header
+static constexpr std::size_t MAX_HEADER = 4096;
+
+Channel::~Channel() {
+    ::close(this->mFd);
+}
+
+std::unique_ptr<Channel> Channel::connect(const std::string &socket) {
+    sockaddr_un address = {};
+    address.sun_family  = AF_UNIX;
+
+    if (socket.size() >= sizeof(address.sun_path)) {
+        return nullptr;
+    }
+
+    std::memcpy(address.sun_path, socket.c_str(), socket.size() + 1);
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    if (0 != ::connect(fd,
+                       reinterpret_cast<const sockaddr *>(&address),
+                       sizeof(address))) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    return std::make_unique<Channel>(fd);
+}
+
+bool Channel::send(const Request &request) {
+    const std::string header =
+        "convert " + request.mFormat + " " + std::to_string(request.mWidth) +
+        " " + std::to_string(request.mPath.size()) + " " +
+        (request.mSource ? std::to_string(request.mSource->size()) : "-") +
+        "\n";
+
+    return this->write(header) && this->write(request.mPath) &&
+           (!request.mSource || this->write(*request.mSource));
+}
+
+bool Channel::send(const Response &response) {
+    const std::string header = std::string(response.mFailed ? "error" : "ok") +
+                               " " + std::to_string(response.mBytesIn) + " " +
+                               std::to_string(response.mBody.size()) + "\n";
+
+    return this->write(header) && this->write(response.mBody);
+}
+
+std::optional<Request> Channel::receive_request() {
+    const auto header = this->read_line();
+
+    if (!header) {
+        return std::nullopt;
+    }
+
+    std::istringstream fields(*header);
+    std::string        command, source_size;
+    std::size_t        path_size = 0;
+    Request            request;
+
+    if (!(fields >> command >> request.mFormat >> request.mWidth >>
+          path_size >> source_size) ||
+        "convert" != command) {
+        return std::nullopt;
+    }
+
+    auto path = this->read(path_size);
+
+    if (!path) {
+        return std::nullopt;
+    }
+
+    request.mPath = std::move(*path);
+
+    if ("-" != source_size) {
+        char      *end  = nullptr;
+        const auto size = std::strtoull(source_size.c_str(), &end, 10);
+
+        if ('\0' != *end) {
+            return std::nullopt;
+        }
+
+        request.mSource = this->read(size);
+
+        if (!request.mSource) {
+            return std::nullopt;
+        }
+    }
+
+    return request;
+}
+
+std::optional<Response> Channel::receive_response() {
+    const auto header = this->read_line();
+
+    if (!header) {
+        return std::nullopt;
+    }
+
+    std::istringstream fields(*header);
+    std::string        status;
+    std::size_t        body_size = 0;
+    Response           response;
+
+    if (!(fields >> status >> response.mBytesIn >> body_size) ||
+        ("ok" != status && "error" != status)) {
+        return std::nullopt;
+    }
+
+    auto body = this->read(body_size);
+
+    if (!body) {
+        return std::nullopt;
+    }
+
+    response.mFailed = "error" == status;
+    response.mBody   = std::move(*body);
+    return response;
+}
+
+bool Channel::write(std::string_view data) {
+    while (!data.empty()) {
+        const ssize_t written = ::write(this->mFd, data.data(), data.size());
+
+        if (written < 0 && EINTR == errno) {
+            continue;
+        }
+
+        if (written <= 0) {
+            return false;
+        }
+
+        data.remove_prefix(written);
+    }
+
+    return true;
+}
+
+std::optional<std::string> Channel::read_line() {
+    while (true) {
+        const std::size_t end = this->mBuffer.find('\n', this->mStart);
+
+        if (std::string::npos != end) {
+            std::string line =
+                this->mBuffer.substr(this->mStart, end - this->mStart);
+            this->mStart = end + 1;
+            return line;
+        }
+
+        if (this->mBuffer.size() - this->mStart > MAX_HEADER) {
+            return std::nullopt;
+        }
+
+        char          chunk[64 * 1024];
+        const ssize_t length = ::read(this->mFd, chunk, sizeof(chunk));
+
+        if (length < 0 && EINTR == errno) {
+            continue;
+        }
+
+        if (length <= 0) {
+            return std::nullopt;
+        }
+
+        this->mBuffer.erase(0, this->mStart);
+        this->mBuffer.append(chunk, length);
+        this->mStart = 0;
+    }
+}
+
+// Takes what is left in the buffer first, then reads the rest straight into
+// the result. Sizes come from the peer, so they are checked before anything
+// is allocated
+std::optional<std::string> Channel::read(std::size_t size) {
+    if (size > this->mMaxField) {
+        return std::nullopt;
+    }
+
+    const std::size_t buffered =
+        std::min(size, this->mBuffer.size() - this->mStart);
+    std::string data = this->mBuffer.substr(this->mStart, buffered);
+    this->mStart += buffered;
+    data.resize(size);
+
+    for (std::size_t done = buffered; done < size;) {
+        const ssize_t length =
+            ::read(this->mFd, data.data() + done, size - done);
+
+        if (length < 0 && EINTR == errno) {
+            continue;
+        }
+
+        if (length <= 0) {
+            return std::nullopt;
+        }
+
+        done += length;
+    }
+
+    return data;
+}
+
+std::string default_socket() {
+    if (const char *runtime = std::getenv("XDG_RUNTIME_DIR");
+        nullptr != runtime && '\0' != *runtime) {
+        return std::string(runtime) + "/louvred.sock";
+    }
+
+    return "/tmp/louvred-" + std::to_string(::getuid()) + ".sock";
+}
+
+} // namespace louvre::cli
@@ -0,0 +1,91 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace louvre::cli {
+// A conversion asked to louvred. The daemon reads the file at mPath, which
+// must be absolute, unless the request carries the source itself, in which
+// case the path is only used to resolve #include and to report errors
+class Request {
+    public:
+    std::string                mFormat;
+    std::size_t                mWidth;
+    std::string                mPath;
+    std::optional<std::string> mSource;
+};
+
+// The output of a conversion, or the error message if mFailed is set.
+// mBytesIn is the size of the source that was converted
+class Response {
+    public:
+    bool        mFailed;
+    std::size_t mBytesIn;
+    std::string mBody;
+};
+
+// One end of a connection to louvred. Each message is a header line with
+// the sizes of its fields, followed by the contents of the fields:
+//
+//   convert <format> <width> <path size> <source size or -> \n path source
+//   ok <bytes in> <output size> \n output
+//   error <bytes in> <message size> \n message
+//
+// A connection carries any number of requests, each followed by its
+// response. Messages with a field larger than the maximum of the channel are
+// rejected as malformed
+class Channel {
+    private:
+    const int         mFd;
+    const std::size_t mMaxField;
+    std::string       mBuffer;
+    std::size_t       mStart;
+
+    public:
+    // Fields up to 256 MiB by default
+    static constexpr std::size_t MAX_FIELD = 256 * 1024 * 1024;
+
+    Channel(int fd, std::size_t max_field = MAX_FIELD)
+        : mFd(fd), mMaxField(max_field), mStart(0) {};
+    Channel(const Channel &) = delete;
+    ~Channel();
+
+    // Returns nullptr if nothing listens on the socket
+    static std::unique_ptr<Channel> connect(const std::string &socket);
+
+    bool send(const Request &request);
+    bool send(const Response &response);
+
+    // Return std::nullopt when the connection is closed or the message is
+    // malformed
+    std::optional<Request>  receive_request();
+    std::optional<Response> receive_response();
+
+    private:
+    bool                       write(std::string_view data);
+    std::optional<std::string> read_line();
+    std::optional<std::string> read(std::size_t size);
+};
+
+// $XDG_RUNTIME_DIR/louvred.sock, or a socket in /tmp named after the user
+std::string default_socket();
+
+} // namespace louvre::cli
@@ -0,0 +1,150 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "jobs.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include "protocol.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#endif
+
+namespace louvre::cli {
+#if defined(__unix__) || defined(__APPLE__)
+std::optional<Summary> convert_remote(const std::string              &socket,
+                                      const Format                   &format,
+                                      std::size_t                     width,
+                                      std::size_t                     threads,
+                                      std::vector<Job>               &jobs,
+                                      const std::vector<std::size_t> &indices) {
+    auto first = Channel::connect(socket);
+
+    if (!first) {
+        return std::nullopt;
+    }
+
+    // A daemon that goes away fails the write instead of killing the client
+    std::signal(SIGPIPE, SIG_IGN);
+
+    if (0 == threads) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    threads = std::max<std::size_t>(1, std::min(threads, indices.size()));
+
+    std::atomic<std::size_t> next      = 0;
+    std::atomic<std::size_t> bytes_in  = 0;
+    std::atomic<std::size_t> bytes_out = 0;
+    std::mutex               mutex;
+    std::vector<std::string> errors;
+    const auto               start = std::chrono::steady_clock::now();
+
+    const auto fail = [&](Job &job, std::string error) {
+        job.mFailed = true;
+        std::lock_guard<std::mutex> lock(mutex);
+        errors.push_back(std::move(error));
+    };
+
+    // Each connection takes the next job until there are none left, or
+    // until the connection is lost
+    const auto work = [&](std::unique_ptr<Channel> channel) {
+        for (std::size_t i = next++; i < indices.size(); i = next++) {
+            Job &job = jobs[indices[i]];
+
+            if (!channel->send(Request{
+                    format.mName,
+                    width,
+                    std::filesystem::absolute(job.mInput).string(),
+                    std::nullopt})) {
+                fail(job, job.mInput + ": connection to louvred lost");
+                return;
+            }
+
+            auto response = channel->receive_response();
+
+            if (!response) {
+                fail(job, job.mInput + ": connection to louvred lost");
+                return;
+            }
+
+            job.mFailed = false;
+
+            if (response->mFailed) {
+                fail(job, std::move(response->mBody));
+            } else if (write_output(job.mOutput, response->mBody)) {
+                bytes_in += response->mBytesIn;
+                bytes_out += response->mBody.size();
+            } else {
+                fail(job, job.mOutput.value_or("stdout") +
+                              ": cannot write output");
+            }
+        }
+    };
+
+    // Connections the daemon does not accept leave their share of the jobs
+    // to the others
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < threads; i++) {
+        workers.emplace_back([&]() {
+            if (auto channel = Channel::connect(socket)) {
+                work(std::move(channel));
+            }
+        });
+    }
+
+    work(std::move(first));
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    // Jobs left over after every connection was lost
+    for (std::size_t i = next; i < indices.size(); i++) {
+        Job &job = jobs[indices[i]];
+        fail(job, job.mInput + ": connection to louvred lost");
+    }
+
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    print_errors(errors);
+    return Summary{
+        indices.size(), errors.size(), bytes_in, bytes_out, elapsed.count()};
+}
+#else
+std::optional<Summary> convert_remote(const std::string              &socket,
+                                      const Format                   &format,
+                                      std::size_t                     width,
+                                      std::size_t                     threads,
+                                      std::vector<Job>               &jobs,
+                                      const std::vector<std::size_t> &indices) {
+    return std::nullopt;
+}
+#endif
+
+} // namespace louvre::cli
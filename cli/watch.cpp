@@ -0,0 +1,295 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "jobs.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <louvre/loader.hpp>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#ifdef __linux__
+#include <cerrno>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace louvre::cli {
+std::vector<std::string> watched_directories(const std::string &input,
+                                             const Job         &job,
+                                             IncludeCache      &includes) {
+    namespace fs = std::filesystem;
+
+    std::vector<std::string> directories = {
+        fs::path(input).parent_path().string()};
+
+    for (const auto &include : job.mIncludes) {
+        directories.push_back(fs::path(include).parent_path().string());
+
+        for (const auto &nested : includes.includes_of(include)) {
+            directories.push_back(fs::path(nested).parent_path().string());
+        }
+    }
+
+    return directories;
+}
+
+std::vector<std::size_t>
+stale_jobs(const std::vector<Job>                &jobs,
+           const std::vector<std::string>        &inputs,
+           const std::unordered_set<std::string> &changed,
+           IncludeCache                          &includes) {
+    std::vector<std::size_t> stale;
+
+    // Cached trees go stale when any file they include changes, however
+    // deeply
+    for (std::size_t i = 0; i < jobs.size(); i++) {
+        const auto &job_includes = jobs[i].mIncludes;
+
+        if (jobs[i].mFailed || changed.contains(inputs[i]) ||
+            std::any_of(job_includes.begin(),
+                        job_includes.end(),
+                        [&](const std::string &include) {
+                            return changed.contains(include) ||
+                                   !includes.is_fresh(include);
+                        })) {
+            stale.push_back(i);
+        }
+    }
+
+    return stale;
+}
+
+#ifdef __linux__
+// Directories watched by one inotify instance, by watch descriptor. Files
+// are watched through their directory, since editors often save by renaming
+// a new file over the old one
+class Watches {
+    private:
+    const int                            mFd;
+    std::unordered_map<int, std::string> mDirectories;
+    std::unordered_set<std::string>      mWatched;
+
+    public:
+    Watches(int fd) : mFd(fd) {};
+
+    ~Watches() {
+        ::close(this->mFd);
+    }
+
+    inline std::size_t size() const {
+        return this->mDirectories.size();
+    }
+
+    void add(const std::string &directory) {
+        if (!this->mWatched.insert(directory).second) {
+            return;
+        }
+
+        const int wd = ::inotify_add_watch(this->mFd,
+                                           directory.c_str(),
+                                           IN_CLOSE_WRITE | IN_MOVED_TO |
+                                               IN_CREATE | IN_DELETE);
+
+        if (0 <= wd) {
+            this->mDirectories[wd] = directory;
+        }
+    }
+
+    void add_tree(const std::string &directory) {
+        this->add(directory);
+
+        std::error_code                                ec;
+        std::filesystem::recursive_directory_iterator it(directory, ec), end;
+
+        for (; !ec && it != end; it.increment(ec)) {
+            if (it->is_directory(ec)) {
+                this->add(canonical_path(it->path()));
+            }
+        }
+    }
+
+    inline const std::string *directory(int wd) const {
+        auto it = this->mDirectories.find(wd);
+        return (this->mDirectories.end() == it) ? nullptr : &it->second;
+    }
+};
+
+int watch(const Options    &options,
+          const Converter  &converter,
+          FileLoader       &loader,
+          std::vector<Job> &jobs) {
+    namespace fs = std::filesystem;
+
+    const int fd = ::inotify_init1(IN_CLOEXEC);
+
+    if (fd < 0) {
+        std::perror("louvre: inotify_init1");
+        return 1;
+    }
+
+    Watches         watches(fd);
+    std::error_code ec;
+
+    for (const auto &input : options.mInputs) {
+        if (fs::is_directory(input, ec)) {
+            watches.add_tree(canonical_path(input));
+        }
+    }
+
+    // Canonical path of the input of every job, to match events against
+    std::vector<std::string>                     inputs;
+    std::unordered_map<std::string, std::size_t> by_input;
+
+    const auto track = [&](std::size_t index) {
+        if (index == inputs.size()) {
+            inputs.push_back(canonical_path(jobs[index].mInput));
+            by_input.emplace(inputs.back(), index);
+        }
+
+        for (const auto &directory : watched_directories(
+                 inputs[index], jobs[index], *converter.includes())) {
+            watches.add(directory);
+        }
+    };
+
+    for (std::size_t i = 0; i < jobs.size(); i++) {
+        track(i);
+    }
+
+    if (!options.mQuiet) {
+        std::fprintf(
+            stderr, "louvre: watching %zu directories\n", watches.size());
+    }
+
+    alignas(inotify_event) char buffer[64 * 1024];
+
+    while (true) {
+        std::unordered_set<std::string> changed;
+        bool                            rescan  = false;
+        int                             timeout = -1;
+        pollfd                          ready   = {fd, POLLIN, 0};
+
+        // Blocks until the first event, then takes the events that are
+        // already queued, so that saving several files rebuilds once
+        while (true) {
+            const int res = ::poll(&ready, 1, timeout);
+
+            if (res < 0 && EINTR == errno) {
+                continue;
+            }
+
+            if (res <= 0) {
+                break;
+            }
+
+            const ssize_t length = ::read(fd, buffer, sizeof(buffer));
+
+            if (length <= 0) {
+                break;
+            }
+
+            for (const char *at = buffer; at < buffer + length;) {
+                const auto *event = reinterpret_cast<const inotify_event *>(at);
+                const auto *dir   = watches.directory(event->wd);
+                at += sizeof(inotify_event) + event->len;
+
+                if (nullptr == dir || 0 == event->len) {
+                    continue;
+                }
+
+                const std::string path =
+                    (fs::path(*dir) / event->name).string();
+
+                if (event->mask & IN_ISDIR) {
+                    if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                        watches.add_tree(path);
+                        rescan = true;
+                    }
+
+                    continue;
+                }
+
+                changed.insert(path);
+
+                if (!by_input.contains(path) &&
+                    options.mExtension == fs::path(path).extension()) {
+                    rescan = true;
+                }
+            }
+
+            timeout = 0;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        auto stale = stale_jobs(jobs, inputs, changed, *converter.includes());
+
+        // New sources in the input directories become new jobs
+        if (rescan) {
+            auto res = collect_jobs(options, converter.format());
+
+            if (auto found = std::get_if<std::vector<Job>>(&res)) {
+                for (auto &job : *found) {
+                    if (!by_input.contains(canonical_path(job.mInput))) {
+                        jobs.push_back(std::move(job));
+                        stale.push_back(jobs.size() - 1);
+                        track(jobs.size() - 1);
+                    }
+                }
+            }
+        }
+
+        if (stale.empty()) {
+            continue;
+        }
+
+        const Summary summary = convert_jobs(converter, loader, jobs, stale);
+
+        for (const auto index : stale) {
+            track(index);
+        }
+
+        if (!options.mQuiet) {
+            const std::chrono::duration<double, std::milli> elapsed =
+                std::chrono::steady_clock::now() - start;
+            std::fprintf(stderr,
+                         "louvre: rebuilt %zu of %zu files in %.1f ms\n",
+                         summary.mFiles - summary.mFailed,
+                         summary.mFiles,
+                         elapsed.count());
+        }
+    }
+}
+#else
+int watch(const Options    &options,
+          const Converter  &converter,
+          FileLoader       &loader,
+          std::vector<Job> &jobs) {
+    std::fprintf(stderr, "louvre: --watch needs inotify, only on Linux\n");
+    return 2;
+}
+#endif
+
+} // namespace louvre::cli
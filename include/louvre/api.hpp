@@ -15,18 +15,36 @@
 
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
+#include <stop_token>
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
 
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 
 namespace louvre {
-enum class ParserAction { End, AddChild, AddChildAndBranch, Ignore };
+enum class ParserAction {
+    End,
+    AddChild,
+    AddChildAndBranch,
+    Ignore,
+    Include,
+    Define,
+    Argument,
+    Expand,
+    Condition,
+    Variable
+};
 
 enum class StandardNodeType {
     Root,
@@ -41,23 +59,27 @@ enum class StandardNodeType {
     Text,
     LineBreak,
     Null,
-    Group
+    Group,
+    Label,
+    Reference
 };
 
 class SourceLocation {
     private:
-    const std::size_t mLine;
-    const std::size_t mColumn;
-    const std::size_t mGlobalOffset;
-    const std::size_t mLineOffset;
+    const std::size_t                        mLine;
+    const std::size_t                        mColumn;
+    const std::size_t                        mGlobalOffset;
+    const std::size_t                        mLineOffset;
+    const std::shared_ptr<const std::string> mPath;
 
     public:
-    SourceLocation(std::size_t line,
-                   std::size_t column,
-                   std::size_t global_offset,
-                   std::size_t line_offset)
+    SourceLocation(std::size_t                        line,
+                   std::size_t                        column,
+                   std::size_t                        global_offset,
+                   std::size_t                        line_offset,
+                   std::shared_ptr<const std::string> path = nullptr)
         : mLine(line), mColumn(column), mGlobalOffset(global_offset),
-          mLineOffset(line_offset) {};
+          mLineOffset(line_offset), mPath(path) {};
 
     inline const std::size_t line() const {
         return this->mLine;
@@ -74,6 +96,12 @@ class SourceLocation {
     inline const std::size_t line_offset() const {
         return this->mLineOffset;
     }
+
+    // File the location refers to, or an empty string if the parser was not
+    // given one
+    inline const std::string path() const {
+        return (nullptr != this->mPath) ? *this->mPath : std::string();
+    }
 };
 
 class Tag {
@@ -86,7 +114,7 @@ class Tag {
     Tag(std::string name, SourceLocation location)
         : mName(name), mLocation(location) {};
 
-    inline const std::string name() const {
+    inline const std::string &name() const {
         return this->mName;
     }
 
@@ -94,7 +122,7 @@ class Tag {
         return this->mLocation;
     }
 
-    inline const std::vector<std::string> arguments() const {
+    inline const std::vector<std::string> &arguments() const {
         return this->mArguments;
     }
 
@@ -105,17 +133,23 @@ class Tag {
 
 class Node : public std::enable_shared_from_this<Node> {
     private:
-    const std::variant<StandardNodeType, std::string> mType;
-    std::optional<std::string>                        mText;
-    std::optional<std::shared_ptr<Tag>>               mTag;
-    std::optional<std::shared_ptr<Node>>              mParent;
-    std::vector<std::shared_ptr<Node>>                mChildren;
-    std::size_t                                       mNum;
+    const std::variant<StandardNodeType, std::string>  mType;
+    std::optional<std::string>                         mText;
+    std::optional<std::shared_ptr<Tag>>                mTag;
+    std::optional<std::shared_ptr<Node>>               mParent;
+    std::vector<std::shared_ptr<Node>>                 mChildren;
+    std::size_t                                        mNum;
+    std::optional<std::shared_ptr<Node>>               mReference;
+    std::size_t                                        mSourceStart;
+    std::size_t                                        mSourceEnd;
+    mutable std::function<void(std::shared_ptr<Node>)> mLoader;
 
     public:
     Node() : Node(StandardNodeType::Root) {};
-    Node(StandardNodeType type) : mType(type) {};
-    Node(std::string type) : mType(type), mNum(0) {};
+    Node(StandardNodeType type)
+        : mType(type), mNum(0), mSourceStart(0), mSourceEnd(0) {};
+    Node(std::string type)
+        : mType(type), mNum(0), mSourceStart(0), mSourceEnd(0) {};
     Node(Node &&other) noexcept = default;
 
     static inline Node text(std::string text) {
@@ -124,11 +158,11 @@ class Node : public std::enable_shared_from_this<Node> {
         return n; // ret val optimization helps here
     }
 
-    inline const std::variant<StandardNodeType, std::string> type() const {
+    inline const std::variant<StandardNodeType, std::string> &type() const {
         return this->mType;
     }
 
-    inline const std::optional<std::string> text() const {
+    inline const std::optional<std::string> &text() const {
         return this->mText;
     }
 
@@ -141,15 +175,61 @@ class Node : public std::enable_shared_from_this<Node> {
     }
 
     inline const std::vector<std::shared_ptr<Node>> children() const {
+        this->materialize();
         return this->mChildren;
     }
 
+    // False for blocks returned by Parser::parse_lazy() whose children have
+    // not been accessed yet
+    inline bool is_loaded() const {
+        return !this->mLoader;
+    }
+
     inline const std::size_t number() const {
         return this->mNum;
     }
 
+    // Label node targeted by a #ref node, set once the parser has resolved
+    // all references
+    inline const std::optional<std::shared_ptr<Node>> reference() const {
+        return this->mReference;
+    }
+
+    // Byte range [start, end) of the source the node was parsed from. Blocks
+    // span from their opening tag to the end of their #end tag
+    inline const std::size_t source_start() const {
+        return this->mSourceStart;
+    }
+
+    inline const std::size_t source_end() const {
+        return this->mSourceEnd;
+    }
+
+    inline bool is(StandardNodeType type) const {
+        auto standard = std::get_if<StandardNodeType>(&this->mType);
+        return nullptr != standard && type == *standard;
+    }
+
+    // Structural hash of the subtree rooted at this node. Two subtrees with
+    // the same types, texts, tags and children hash to the same value
+    std::size_t hash() const;
+
+    // Deep copy of the subtree rooted at this node, without parent and
+    // resolved reference. Nodes found in replacements are swapped for copies
+    // of their replacements. If given, keep is called before each node is
+    // copied, and the copy stops with nullptr once it returns false
+    std::shared_ptr<Node>
+    clone(const std::unordered_map<const Node *, std::shared_ptr<Node>>
+                                       &replacements = {},
+          const std::function<bool()> &keep         = nullptr) const;
+
+    // Copy of this node alone, with parent and resolved reference. The copy
+    // shares the children of this node, which keep this node as their parent
+    std::shared_ptr<Node> copy() const;
+
     inline void add_child(std::shared_ptr<Node> child) {
-        child->mNum = this->children().size();
+        this->materialize();
+        child->mNum = this->mChildren.size();
         this->add_dangling_child(child);
         child->set_parent(this->shared_from_this());
     }
@@ -162,9 +242,43 @@ class Node : public std::enable_shared_from_this<Node> {
         this->mParent = parent;
     }
 
+    // Replaces the children without touching them, for trees that share
+    // nodes with other trees
+    inline void set_children(std::vector<std::shared_ptr<Node>> children) {
+        this->materialize();
+        this->mChildren = std::move(children);
+    }
+
+    inline void set_number(std::size_t number) {
+        this->mNum = number;
+    }
+
     inline void set_tag(std::shared_ptr<Tag> tag) {
         this->mTag = tag;
     }
+
+    inline void set_reference(std::shared_ptr<Node> target) {
+        this->mReference = target;
+    }
+
+    inline void set_source_range(std::size_t start, std::size_t end) {
+        this->mSourceStart = start;
+        this->mSourceEnd   = end;
+    }
+
+    // Called with the node itself to add its children on first access
+    inline void set_loader(std::function<void(std::shared_ptr<Node>)> loader) {
+        this->mLoader = loader;
+    }
+
+    private:
+    inline void materialize() const {
+        if (this->mLoader) {
+            auto loader   = std::move(this->mLoader);
+            this->mLoader = nullptr;
+            loader(std::const_pointer_cast<Node>(this->shared_from_this()));
+        }
+    }
 };
 
 class SyntaxError {
@@ -221,35 +335,475 @@ class NodeError {
     }
 };
 
+// Returned by Parser::parse() when the deadline passed or a stop was
+// requested. The location is where the parser stopped
+class CancelledError {
+    private:
+    const SourceLocation mLocation;
+
+    public:
+    CancelledError(SourceLocation location) : mLocation(location) {};
+
+    inline const SourceLocation location() const {
+        return this->mLocation;
+    }
+};
+
+// Hard limits set with Parser::set_limit(). Memory is an estimate of the
+// bytes taken by nodes, tags and text, not an exact count
+enum class Limit {
+    Depth,
+    Nodes,
+    Tags,
+    TextLength,
+    Arguments,
+    Memory
+};
+
+// Returned by Parser::parse() as soon as the document exceeds one of the
+// limits. The location is where the parser stopped
+class LimitError {
+    private:
+    const std::string    mMessage;
+    const Limit          mLimit;
+    const SourceLocation mLocation;
+
+    public:
+    LimitError(std::string message, Limit limit, SourceLocation location)
+        : mMessage(message), mLimit(limit), mLocation(location) {};
+
+    inline const std::string message() const {
+        return this->mMessage;
+    }
+
+    inline const Limit limit() const {
+        return this->mLimit;
+    }
+
+    inline const SourceLocation location() const {
+        return this->mLocation;
+    }
+};
+
+// Open addressing hash table (linear probing) mapping #label names to their
+// nodes
+class LabelIndex {
+    private:
+    class Slot {
+        public:
+        std::size_t           mHash;
+        std::string           mName;
+        std::shared_ptr<Node> mNode;
+    };
+
+    std::vector<Slot> mSlots;
+    std::size_t       mCount;
+
+    public:
+    LabelIndex() : mCount(0) {};
+
+    // Returns false if a label with the same name is already present
+    bool insert(const std::string &name, std::shared_ptr<Node> node);
+
+    const std::optional<std::shared_ptr<Node>>
+    find(const std::string &name) const;
+
+    inline const std::size_t size() const {
+        return this->mCount;
+    }
+
+    private:
+    static std::size_t hash(const std::string &name);
+    void               grow();
+};
+
+// Headings recorded by the parser as it creates them. Each entry holds the
+// heading node, its nesting depth among headings and its title, which is the
+// first text child of the heading. Titles are stored back to back in a
+// single buffer
+class TableOfContents {
+    private:
+    class Entry {
+        public:
+        std::size_t           mDepth;
+        std::size_t           mTitleOffset;
+        std::size_t           mTitleLength;
+        bool                  mTitled;
+        std::shared_ptr<Node> mNode;
+    };
+
+    std::vector<Entry> mEntries;
+    std::string        mTitles;
+
+    public:
+    inline const std::size_t size() const {
+        return this->mEntries.size();
+    }
+
+    inline const std::size_t depth(std::size_t entry) const {
+        return this->mEntries.at(entry).mDepth;
+    }
+
+    inline const std::string_view title(std::size_t entry) const {
+        const Entry &e = this->mEntries.at(entry);
+        return std::string_view(this->mTitles).substr(e.mTitleOffset,
+                                                      e.mTitleLength);
+    }
+
+    inline const std::shared_ptr<Node> node(std::size_t entry) const {
+        return this->mEntries.at(entry).mNode;
+    }
+
+    inline std::size_t add_entry(std::size_t           depth,
+                                 std::shared_ptr<Node> node) {
+        this->mEntries.push_back(Entry{depth, 0, 0, false, node});
+        return this->mEntries.size() - 1;
+    }
+
+    inline bool has_title(std::size_t entry) const {
+        return this->mEntries.at(entry).mTitled;
+    }
+
+    inline void set_title(std::size_t entry, const std::string &title) {
+        Entry &e       = this->mEntries.at(entry);
+        e.mTitleOffset = this->mTitles.length();
+        e.mTitleLength = title.length();
+        e.mTitled      = true;
+        this->mTitles += title;
+    }
+};
+
+// Document rules checked by the parser as it adds each node. A type that
+// appears as a child in allow() may only be added under the parents allowed
+// for it, while types never mentioned may appear anywhere. Rules are
+// compiled into a dense parent x child table, so that each check costs a few
+// array lookups
+class Schema {
+    private:
+    std::vector<std::pair<std::variant<StandardNodeType, std::string>,
+                          std::variant<StandardNodeType, std::string>>>
+                                                   mRules;
+    std::unordered_map<std::string, std::pair<std::size_t, std::size_t>>
+                                                   mArgumentCounts;
+    std::size_t                                    mMaxDepth;
+    std::vector<std::uint16_t>                     mStandardIds;
+    std::unordered_map<std::string, std::uint16_t> mCustomIds;
+    std::size_t                                    mTypeCount;
+    std::vector<std::uint8_t>                      mTable;
+
+    public:
+    Schema() : mMaxDepth(SIZE_MAX), mTypeCount(1) {};
+
+    inline void allow(std::variant<StandardNodeType, std::string> parent,
+                      std::variant<StandardNodeType, std::string> child) {
+        this->mRules.push_back(std::make_pair(parent, child));
+    }
+
+    inline void
+    set_argument_count(std::string tag, std::size_t min, std::size_t max) {
+        this->mArgumentCounts[tag] = std::make_pair(min, max);
+    }
+
+    // The root is at depth 0, its children at depth 1 and so on
+    inline void set_max_depth(std::size_t depth) {
+        this->mMaxDepth = depth;
+    }
+
+    void compile();
+
+    // Dense id of the type of a node. Types without rules share id 0
+    inline std::uint16_t id_of(const Node &node) const {
+        return this->type_id(node.type());
+    }
+
+    // Returns the reason why the node may not be added under a parent with
+    // the given id at the given depth, if any
+    const std::optional<std::string> check(const Node   &node,
+                                           std::uint16_t id,
+                                           std::uint16_t parent,
+                                           std::size_t   depth) const;
+
+    private:
+    std::uint16_t
+    type_id(const std::variant<StandardNodeType, std::string> &type) const;
+    void assign_id(const std::variant<StandardNodeType, std::string> &type);
+};
+
+// Outcome of parsing a document, or a file it includes
+using ParseResult = std::variant<std::shared_ptr<Node>,
+                                 SyntaxError,
+                                 TagError,
+                                 NodeError,
+                                 CancelledError,
+                                 LimitError>;
+
+// Parses the source of an included file
+using IncludeLoader = std::function<ParseResult(std::string)>;
+
+// Defined in louvre/include.hpp
+class IncludeCache;
+
 class Parser {
+    public:
+    // Called with the bytes consumed so far, the total number of bytes if
+    // known, and the number of nodes built so far
+    using Progress = std::function<void(std::size_t                consumed,
+                                        std::optional<std::size_t> total,
+                                        std::size_t                nodes)>;
+
     private:
-    const std::string mSource;
+    // Body of a #define(name, params...) block. #arg(param) tags in the body
+    // are slots, replaced by the matching argument of each invocation.
+    // A #label in the body is indexed by every expansion, so a second
+    // invocation fails with "Duplicate label" at the #label tag.
+    // mNodes and mTextLength measure the body without its slots, so that
+    // expansions are counted before they are cloned
+    class Macro {
+        public:
+        std::vector<std::string>                          mParameters;
+        std::shared_ptr<Node>                             mBody;
+        std::vector<std::pair<const Node *, std::size_t>> mSlots;
+        std::size_t                                       mNodes      = 0;
+        std::size_t                                       mTextLength = 0;
+    };
+
+    class NameHash {
+        public:
+        using is_transparent = void;
+
+        inline std::size_t operator()(std::string_view name) const {
+            return std::hash<std::string_view>{}(name);
+        }
+    };
+
+    using NameSet = std::unordered_set<std::string, NameHash, std::equal_to<>>;
+
+    // State shared by the blocks of a document parsed in lazy mode. Blocks
+    // are sorted by the offset of their opening tag, and record where their
+    // matching #end starts and ends
+    class Lazy {
+        public:
+        class Block {
+            public:
+            std::size_t mStart;
+            std::size_t mContentEnd;
+            std::size_t mEnd;
+        };
+
+        std::shared_ptr<const std::string> mSource;
+        std::vector<Block>                 mBlocks;
+        std::unordered_map<
+            std::string,
+            std::function<std::pair<ParserAction, Node>(std::shared_ptr<Tag>)>>
+                                                     mBindings;
+        NameSet                                      mBlockTags;
+        std::unordered_set<std::string>              mFeatures;
+        std::unordered_map<std::string, std::string> mVariables;
+        std::unordered_map<std::string, Macro>       mMacros;
+        std::shared_ptr<IncludeCache>                mIncludes;
+        std::shared_ptr<const std::string>           mPath;
+        std::vector<ParseResult>                     mErrors;
+        std::array<std::size_t, 6>                   mLimits;
+
+        // Totals of the document so far, limited as in parse()
+        std::size_t                                  mNodeCount;
+        std::size_t                                  mTagCount;
+        std::size_t                                  mMemory;
+    };
+
+    const std::shared_ptr<const std::string> mSource;
+    std::size_t                              mEnd;
     std::unordered_map<
         std::string,
         std::function<std::pair<ParserAction, Node>(std::shared_ptr<Tag>)>>
-                mTagBindings;
-    std::size_t mGlobalOffset;
-    std::size_t mLineOffset;
-    std::size_t mLine;
-    std::size_t mColumn;
+                                                               mTagBindings;
+    std::size_t                                                mGlobalOffset;
+    std::size_t                                                mLineOffset;
+    std::size_t                                                mLine;
+    std::size_t                                                mColumn;
+    LabelIndex                                                 mLabels;
+    std::vector<std::shared_ptr<Node>>                         mReferences;
+    std::vector<std::variant<StandardNodeType, std::string>>   mHeadingTypes;
+    std::vector<std::pair<std::shared_ptr<Node>, std::size_t>> mOpenHeadings;
+    TableOfContents                                            mToc;
+    std::optional<Schema>                                      mSchema;
+    std::vector<std::uint16_t>                                 mSchemaParents;
+    std::shared_ptr<const std::string>                         mPath;
+    std::shared_ptr<IncludeCache>                              mIncludes;
+    std::vector<std::string>                                   mIncluded;
+    bool                                                       mDeferReferences;
+    std::unordered_map<std::string, Macro>                     mMacros;
+    std::optional<std::pair<std::string, Macro>>               mDefinition;
+    std::unordered_set<std::string>                            mFeatures;
+    std::vector<std::shared_ptr<Node>>                         mConditions;
+    NameSet                                                    mBlockTags;
+    std::unordered_map<std::string_view, std::string_view>     mVariables;
+    std::shared_ptr<Lazy>                                      mLazy;
+    std::optional<std::chrono::steady_clock::time_point>       mDeadline;
+    std::stop_token                                            mStop;
+    bool                                                       mCancellable;
+    std::size_t                                                mNextCancel;
+    std::size_t                                                mNextCheck;
+    std::array<std::size_t, 6>                                 mLimits;
+    std::size_t                                                mDepth;
+    std::size_t                                                mNodeCount;
+    std::size_t                                                mTagCount;
+    std::size_t                                                mMemory;
+    Progress                                                   mProgress;
+    std::size_t                                                mProgressStep;
+    std::size_t                                                mNextProgress;
 
     public:
     Parser(std::string source);
 
+    // The path is reported in error locations and #include(path) resolves
+    // relative paths against its directory
+    Parser(std::string source, std::string path);
+
     inline void add_tag_binding(
         std::string tag,
         std::function<std::pair<ParserAction, Node>(std::shared_ptr<Tag>)>
             binding) {
+        this->mBlockTags.erase(tag);
         this->mTagBindings[tag] = binding;
     }
 
-    std::variant<std::shared_ptr<Node>, SyntaxError, TagError, NodeError>
-    parse();
+    // Same as add_tag_binding(), for tags closed by a matching #end. Blocks
+    // skipped by #if and scanned ahead in lazy mode are matched by tag name
+    // alone, without calling any binding, so a binding that may branch must
+    // be added through this
+    inline void add_block_tag_binding(
+        std::string tag,
+        std::function<std::pair<ParserAction, Node>(std::shared_ptr<Tag>)>
+            binding) {
+        this->add_tag_binding(tag, std::move(binding));
+        this->mBlockTags.insert(std::move(tag));
+    }
+
+    // Stops with a CancelledError once the deadline passes or a stop is
+    // requested. Both are checked every few blocks, every few kilobytes
+    // within a block or a skipped #if, and while waiting for an included
+    // file. They cost a single branch per block and per byte of text when
+    // not given
+    std::variant<std::shared_ptr<Node>,
+                 SyntaxError,
+                 TagError,
+                 NodeError,
+                 CancelledError,
+                 LimitError>
+    parse(std::optional<std::chrono::steady_clock::time_point> deadline =
+              std::nullopt,
+          std::stop_token stop = std::stop_token());
+
+    // Builds only the top-level nodes after a quick scan for the #end of
+    // every block. The content of a block is parsed on the first call to its
+    // children(), lazily in turn. Labels are not resolved, schemas and the
+    // table of contents only see the nodes built by this call, and nodes must
+    // not be accessed from multiple threads
+    std::variant<std::shared_ptr<Node>,
+                 SyntaxError,
+                 TagError,
+                 NodeError,
+                 CancelledError,
+                 LimitError>
+    parse_lazy(std::optional<std::chrono::steady_clock::time_point> deadline =
+                   std::nullopt,
+               std::stop_token stop = std::stop_token());
+
+    // Errors found while materializing blocks returned by parse_lazy(). The
+    // blocks keep the children parsed up to the error
+    inline const std::vector<ParseResult> lazy_errors() const {
+        return (nullptr != this->mLazy) ? this->mLazy->mErrors
+                                        : std::vector<ParseResult>();
+    }
+
+    inline const LabelIndex &labels() const {
+        return this->mLabels;
+    }
+
+    // Opt-in: record nodes of the given types into the table of contents as
+    // parse() creates them
+    inline void collect_toc(
+        std::vector<std::variant<StandardNodeType, std::string>> types) {
+        this->mHeadingTypes = types;
+    }
+
+    inline const TableOfContents &toc() const {
+        return this->mToc;
+    }
+
+    // Checks every node against the schema as parse() adds it
+    inline void set_schema(Schema schema) {
+        schema.compile();
+        this->mSchema = std::move(schema);
+    }
+
+    // Features tested by #if(feature). Blocks whose condition does not hold
+    // are skipped without building any node
+    inline void set_features(std::unordered_set<std::string> features) {
+        this->mFeatures = std::move(features);
+    }
+
+    // Values of #var(name) tags. The caller keeps the strings alive until
+    // parse() returns
+    inline void set_variables(
+        std::unordered_map<std::string_view, std::string_view> variables) {
+        this->mVariables = std::move(variables);
+    }
+
+    // Shares parsed included files with other parsers. A file cached by a
+    // parser with other tag bindings, features, variables or limits is
+    // parsed again. Parsers create a private cache on the first #include
+    // otherwise
+    inline void set_include_cache(std::shared_ptr<IncludeCache> cache) {
+        this->mIncludes = cache;
+    }
+
+    // Canonical paths of the files included directly by the document, in
+    // the order of their #include tags
+    inline const std::vector<std::string> &included_files() const {
+        return this->mIncluded;
+    }
+
+    // Fails with a LimitError as soon as the document exceeds the limit.
+    // Lazily parsed blocks count towards the limits of their document, and
+    // report it through lazy_errors(). Included files are checked on their
+    // own, and no limit is set by default
+    inline void set_limit(Limit limit, std::size_t value) {
+        this->mLimits[static_cast<std::size_t>(limit)] = value;
+    }
+
+    // Reports progress once at least interval bytes were consumed since the
+    // last report, checked between blocks and within long blocks, and once
+    // more when parse() succeeds. Lazily parsed blocks and included files
+    // are not reported
+    inline void set_progress(Progress callback, std::size_t interval) {
+        this->mProgress     = callback;
+        this->mProgressStep = interval;
+    }
 
     private:
+    Parser(std::shared_ptr<const std::string> source);
+
+    const std::optional<ParseResult>
+         parse_into(std::shared_ptr<Node> base);
+    void start(std::optional<std::chrono::steady_clock::time_point> deadline,
+               std::stop_token                                      stop);
+    bool                                cancelled() const;
+    const std::optional<CancelledError> check_cancelled(std::size_t offset);
+    const std::optional<CancelledError> check_block();
+    void                                report_progress();
+    const std::optional<CancelledError> prescan();
+    const Lazy::Block                  *lazy_block(std::size_t start) const;
+    void defer_block(std::shared_ptr<Node> block, const Lazy::Block &range);
     static inline bool               is_tag_char(char c);
+    static inline bool               is_blank(const std::string &s);
     static inline std::string        trim(std::string &s);
     inline const SourceLocation      location() const;
+    inline std::size_t               limit(Limit limit) const;
+    const std::optional<LimitError>  count_node(std::size_t text_length);
+    const std::optional<LimitError>  count_nodes(std::size_t count,
+                                                 std::size_t text_length);
     inline bool                      can_advance(std::size_t amount = 0) const;
     inline void                      advance(std::size_t amount = 1);
     inline const std::optional<char> peek(std::size_t ahead = 0) const;
@@ -259,15 +813,51 @@ class Parser {
     void                             skip_whitespace();
     const std::variant<char, SyntaxError>
                 consume_if(const std::string &allowed);
+    bool        is_variable_tag() const;
     std::string collect_sequence();
-    const std::variant<std::shared_ptr<Tag>, SyntaxError> collect_tag();
+    std::string collect_argument();
+    const std::variant<std::shared_ptr<Tag>, SyntaxError, LimitError>
+    collect_tag();
     const std::variant<std::pair<ParserAction, std::shared_ptr<Node>>, TagError>
     tag_to_node(std::shared_ptr<Tag> tag);
     const std::optional<
         std::variant<std::pair<ParserAction, std::shared_ptr<Node>>,
                      SyntaxError,
-                     TagError>>
-    collect_block();
+                     TagError,
+                     CancelledError,
+                     LimitError>>
+                                  collect_block();
+    const std::optional<TagError> index_label(std::shared_ptr<Node> node);
+    const std::optional<TagError> resolve_references();
+    void                          record_heading(std::shared_ptr<Node> node);
+    void record_heading_title(std::shared_ptr<Node> parent,
+                              std::shared_ptr<Node> node);
+    const std::string        resolve_include(const std::string &path) const;
+    const std::string        include_config() const;
+    const IncludeLoader      include_loader(const std::string &path) const;
+    std::vector<std::size_t> prefetch_includes();
+    const std::optional<ParseResult>
+    include(std::shared_ptr<Node> parent, std::shared_ptr<Node> directive);
+    const std::optional<TagError> define(std::shared_ptr<Node> parent,
+                                         std::shared_ptr<Node> directive);
+    void                          register_macro();
+    const std::variant<bool, TagError>
+         test_condition(std::shared_ptr<Tag> tag) const;
+    bool opens_block(std::string_view name) const;
+    const std::variant<std::string_view, TagError>
+         resolve_variable(std::shared_ptr<Tag> tag) const;
+    const std::optional<CancelledError> skip_block();
+    void                                skip_to(std::size_t offset);
+    const std::optional<TagError> add_slot(std::shared_ptr<Node> parent,
+                                           std::shared_ptr<Node> slot);
+    const std::optional<ParseResult>
+    expand(std::shared_ptr<Node> parent, std::shared_ptr<Node> invocation);
+    const std::optional<ParseResult>
+    adopt(std::shared_ptr<Node> parent,
+          std::shared_ptr<Node> node,
+          std::size_t           start,
+          std::size_t           end,
+          bool                  counted = false);
 };
 
 } // namespace louvre
@@ -0,0 +1,209 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <louvre/api.hpp>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace louvre {
+using NodeIndex = std::uint32_t;
+
+class FrozenDocument;
+
+// Flat, preorder view of a parsed tree. Every node is identified by its
+// preorder index, so the descendants of node i are exactly the nodes in
+// [i + 1, subtree_end(i)). Nodes are also indexed by type and by tag name
+// into sorted posting lists, which turns descendant queries into two binary
+// searches. The tree must not be modified while a Document refers to it
+class Document {
+    private:
+    std::shared_ptr<Node>                       mRoot;
+    std::vector<std::shared_ptr<Node>>          mNodes;
+    std::vector<NodeIndex>                      mParents;
+    std::vector<NodeIndex>                      mEnds;
+    std::vector<std::uint32_t>                  mDepths;
+    std::vector<std::uint32_t>                  mChildOffsets;
+    std::vector<NodeIndex>                      mChildren;
+    std::vector<std::size_t>                    mSourceStarts;
+    std::vector<std::size_t>                    mSourceEnds;
+    std::unordered_map<const Node *, NodeIndex> mIndices;
+    std::unordered_map<std::variant<StandardNodeType, std::string>,
+                       std::vector<NodeIndex>>
+                                                            mTypes;
+    std::unordered_map<std::string, std::vector<NodeIndex>> mTags;
+    std::unordered_map<std::string, NodeIndex>              mLabels;
+
+    public:
+    Document(std::shared_ptr<Node> root);
+
+    inline const std::shared_ptr<Node> root() const {
+        return this->mRoot;
+    }
+
+    inline const std::size_t size() const {
+        return this->mNodes.size();
+    }
+
+    inline const std::shared_ptr<Node> &node(NodeIndex index) const {
+        return this->mNodes[index];
+    }
+
+    const std::optional<NodeIndex>
+    index_of(const std::shared_ptr<Node> &node) const;
+
+    // The root is its own parent
+    inline const NodeIndex parent(NodeIndex index) const {
+        return this->mParents[index];
+    }
+
+    inline const std::uint32_t depth(NodeIndex index) const {
+        return this->mDepths[index];
+    }
+
+    inline const NodeIndex subtree_end(NodeIndex index) const {
+        return this->mEnds[index];
+    }
+
+    inline bool is_ancestor(NodeIndex ancestor, NodeIndex node) const {
+        return ancestor < node && node < this->mEnds[ancestor];
+    }
+
+    inline const std::span<const NodeIndex> children(NodeIndex index) const {
+        return std::span<const NodeIndex>(this->mChildren).subspan(
+            this->mChildOffsets[index],
+            this->mChildOffsets[index + 1] - this->mChildOffsets[index]);
+    }
+
+    const std::optional<NodeIndex> nth_child(NodeIndex index,
+                                             std::size_t n) const;
+
+    // Innermost node whose source range contains the byte offset, found by
+    // binary searching the children of each node on the path from the root.
+    // Runs in O(depth * log(children)) and does not allocate
+    const std::optional<NodeIndex> node_at(std::size_t offset) const;
+
+    // Ancestors of the node, from its parent up to the root
+    const std::vector<NodeIndex> ancestors(NodeIndex index) const;
+
+    // All nodes of the given type, in preorder
+    const std::span<const NodeIndex>
+    of_type(const std::variant<StandardNodeType, std::string> &type) const;
+
+    const std::span<const NodeIndex> descendants_of_type(
+        NodeIndex index,
+        const std::variant<StandardNodeType, std::string> &type) const;
+
+    // The #label with the given name, the first one if there are several
+    const std::optional<NodeIndex> label(const std::string &name) const;
+
+    // Label targeted by a #ref node. Targets are looked up by name rather
+    // than through Node::reference(), so that they are found in this tree
+    // even if it is an edited version that shares the #ref node
+    const std::optional<NodeIndex> reference(NodeIndex index) const;
+
+    // All nodes created by a tag with the given name, in preorder
+    const std::span<const NodeIndex> with_tag(const std::string &name) const;
+
+    const std::span<const NodeIndex>
+    descendants_with_tag(NodeIndex index, const std::string &name) const;
+
+    // Immutable view of the tree for concurrent readers
+    FrozenDocument freeze() const;
+
+    private:
+    const std::span<const NodeIndex>
+    in_subtree(NodeIndex index, const std::span<const NodeIndex> list) const;
+};
+
+// Read-only view of a parsed tree, meant to be shared by many threads. Nodes
+// are addressed by their preorder index like in Document, and everything a
+// reader needs is stored as plain indices and pointers into the tree, which
+// the view keeps alive. Walking it never copies a shared_ptr, so concurrent
+// readers do not contend on reference counts. Node's own accessors still
+// copy shared_ptrs and should be avoided on hot paths
+class FrozenDocument {
+    private:
+    std::shared_ptr<const Node> mRoot;
+    std::vector<const Node *>   mNodes;
+    std::vector<const Tag *>    mTags;
+    std::vector<NodeIndex>      mReferences;
+    std::vector<NodeIndex>      mParents;
+    std::vector<NodeIndex>      mEnds;
+    std::vector<std::uint32_t>  mDepths;
+    std::vector<std::uint32_t>  mChildOffsets;
+    std::vector<NodeIndex>      mChildren;
+
+    public:
+    FrozenDocument(const Document &document);
+
+    inline const std::size_t size() const {
+        return this->mNodes.size();
+    }
+
+    inline const Node &node(NodeIndex index) const {
+        return *this->mNodes[index];
+    }
+
+    inline const std::variant<StandardNodeType, std::string> &
+    type(NodeIndex index) const {
+        return this->mNodes[index]->type();
+    }
+
+    inline const std::optional<std::string> &text(NodeIndex index) const {
+        return this->mNodes[index]->text();
+    }
+
+    // Tag that created the node, or nullptr
+    inline const Tag *tag(NodeIndex index) const {
+        return this->mTags[index];
+    }
+
+    // Label targeted by a #ref node
+    inline const std::optional<NodeIndex> reference(NodeIndex index) const {
+        const NodeIndex target = this->mReferences[index];
+        return (index != target) ? std::optional<NodeIndex>(target)
+                                 : std::nullopt;
+    }
+
+    // The root is its own parent
+    inline const NodeIndex parent(NodeIndex index) const {
+        return this->mParents[index];
+    }
+
+    inline const std::uint32_t depth(NodeIndex index) const {
+        return this->mDepths[index];
+    }
+
+    inline const NodeIndex subtree_end(NodeIndex index) const {
+        return this->mEnds[index];
+    }
+
+    inline const std::span<const NodeIndex> children(NodeIndex index) const {
+        return std::span<const NodeIndex>(this->mChildren).subspan(
+            this->mChildOffsets[index],
+            this->mChildOffsets[index + 1] - this->mChildOffsets[index]);
+    }
+};
+
+} // namespace louvre
@@ -0,0 +1,73 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <louvre/api.hpp>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace louvre {
+// Position of a node as the indices of the children taken from the root
+using NodePath = std::vector<std::size_t>;
+
+// One version of a tree, edited by path copying: every edit returns a new
+// version that copies only the nodes from the root down to the parent of
+// the change, and shares every other subtree with the old version. An edit
+// costs O(depth) node copies plus the child lists of the copied nodes, and
+// the old version is left untouched, so cached trees can be edited safely.
+// Nodes must not be modified in place once they belong to a version.
+//
+// Shared nodes keep the parent, number and resolved reference they had in
+// the version they were created in. Use a Document built from the root for
+// positions and #ref targets in an edited version: TextEmitter and
+// Document never rely on parent() or Node::reference(). Nodes passed to an
+// edit that have no parent are adopted by their new parent
+class TreeVersion {
+    private:
+    std::shared_ptr<Node> mRoot;
+
+    public:
+    TreeVersion(std::shared_ptr<Node> root) : mRoot(root) {};
+
+    inline const std::shared_ptr<Node> &root() const {
+        return this->mRoot;
+    }
+
+    // std::nullopt if the path leads nowhere
+    const std::optional<std::shared_ptr<Node>> at(const NodePath &path) const;
+
+    // The edits return std::nullopt if the path is invalid
+    const std::optional<TreeVersion> replace(const NodePath       &path,
+                                             std::shared_ptr<Node> node) const;
+
+    // Inserts node as child number index of the node at parent. An index
+    // equal to the number of children appends it
+    const std::optional<TreeVersion> insert(const NodePath       &parent,
+                                            std::size_t           index,
+                                            std::shared_ptr<Node> node) const;
+
+    // The root cannot be removed
+    const std::optional<TreeVersion> remove(const NodePath &path) const;
+
+    private:
+    // Copies of the nodes from the root to the node at path, root first, or
+    // an empty vector if the path is invalid
+    std::vector<std::shared_ptr<Node>> copy_path(const NodePath &path) const;
+};
+
+} // namespace louvre
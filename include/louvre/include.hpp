@@ -0,0 +1,120 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <future>
+#include <louvre/api.hpp>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace louvre {
+// Parsed files shared by all parsers that use the same cache, so that each
+// included file is parsed at most once as long as it does not change on disk.
+// Files are keyed by canonical path and modification time, and a file is
+// parsed again if any file it includes changed as well, or if a parser
+// configured differently needs it. Parsers prefetch the files they include
+// on other threads, and a parser that needs a file that is still being
+// parsed waits for it. Waits are tracked so that files including each other
+// are reported as a cycle instead of deadlocking
+class IncludeCache {
+    public:
+    using Result = ParseResult;
+
+    // Called at most once per file version
+    using Loader = IncludeLoader;
+
+    private:
+    class Entry {
+        public:
+        std::filesystem::file_time_type                      mTime;
+        std::size_t                                          mGeneration;
+        std::shared_future<std::optional<Result>>            mResult;
+        std::vector<std::pair<std::string, std::size_t>>     mIncludes;
+        std::string                                          mConfig;
+    };
+
+    std::mutex                                        mMutex;
+    std::size_t                                       mParses;
+    std::size_t                                       mInFlight;
+    const std::size_t                                 mMaxInFlight;
+    std::unordered_map<std::string, Entry>            mEntries;
+    std::unordered_multimap<std::string, std::string> mWaits;
+    std::size_t                                       mNextWorker;
+    std::unordered_map<std::size_t, std::thread>      mWorkers;
+
+    public:
+    IncludeCache();
+    ~IncludeCache();
+
+    // Starts parsing the file on another thread, unless it is already cached
+    // or enough files are being parsed already. Returns the id of the thread,
+    // which the caller passes to join() once it no longer needs the file.
+    // Trees are only shared between loaders with the same config, which
+    // describes everything the tree depends on besides the file itself
+    const std::optional<std::size_t> prefetch(const std::string &path,
+                                              const std::string &config,
+                                              Loader             loader);
+    void                             join(std::size_t worker);
+
+    // Tree of the file included by waiter, parsed on this thread unless
+    // another parser got to it first, in which case the future may not be
+    // ready yet. Holds std::nullopt if the file cannot be read
+    const std::shared_future<std::optional<Result>>
+    get(const std::string &waiter,
+        const std::string &path,
+        const std::string &config,
+        Loader             loader);
+
+    // Records that waiter is about to wait for path. Returns false if path
+    // is, directly or indirectly, waiting for waiter
+    bool begin_wait(const std::string &waiter, const std::string &path);
+    void end_wait(const std::string &waiter, const std::string &path);
+
+    // Number of files parsed through the cache so far
+    std::size_t parses();
+
+    // Whether the cached tree of the file is still valid, meaning that
+    // neither the file nor any file it includes changed since it was parsed
+    bool is_fresh(const std::string &path);
+
+    // Generation of the cached tree of the file, which changes every time
+    // the file is parsed again, or std::nullopt if the tree is not fresh
+    const std::optional<std::size_t> version(const std::string &path);
+
+    // Files included by the cached tree of the file, directly or through
+    // other included files, each listed once
+    const std::vector<std::string> includes_of(const std::string &path);
+
+    private:
+    const std::optional<std::filesystem::file_time_type>
+    modified(const std::string &path) const;
+    bool is_fresh(const std::string                     &path,
+                  const std::filesystem::file_time_type &time,
+                  std::vector<std::string>              &seen) const;
+    bool is_hit(const std::string                     &path,
+                const std::filesystem::file_time_type &time,
+                const std::string                     &config) const;
+};
+
+} // namespace louvre
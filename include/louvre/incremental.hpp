@@ -0,0 +1,99 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <louvre/api.hpp>
+#include <louvre/sourcemap.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace louvre {
+// Replaces mLength bytes starting at mOffset in the previous output with
+// mReplacement. Offsets always refer to the previous output, so a list of
+// patches must be applied from the last one to the first one
+class Patch {
+    private:
+    const std::size_t mOffset;
+    const std::size_t mLength;
+    const std::string mReplacement;
+
+    public:
+    Patch(std::size_t offset, std::size_t length, std::string replacement)
+        : mOffset(offset), mLength(length), mReplacement(replacement) {};
+
+    inline const std::size_t offset() const {
+        return this->mOffset;
+    }
+
+    inline const std::size_t length() const {
+        return this->mLength;
+    }
+
+    inline const std::string &replacement() const {
+        return this->mReplacement;
+    }
+};
+
+// Wraps a block renderer and re-renders only the top-level blocks whose
+// structural hash changed since the previous call to emit()
+class IncrementalEmitter {
+    private:
+    class Block {
+        public:
+        std::size_t mHash;
+        std::size_t mOffset;
+        std::size_t mLength;
+        std::size_t mSource;
+    };
+
+    const std::function<std::string(std::shared_ptr<Node>)> mRenderer;
+    std::string                                             mOutput;
+    std::vector<Block>                                      mBlocks;
+    std::size_t                                             mRendered;
+    bool                                                    mMapSource;
+    SourceMap                                               mSourceMap;
+
+    public:
+    IncrementalEmitter(
+        std::function<std::string(std::shared_ptr<Node>)> renderer)
+        : mRenderer(renderer), mRendered(0), mMapSource(false) {};
+
+    // Maps the start of each block in the output to the start of its node
+    // in the source. Costs nothing unless enabled
+    inline void enable_source_map() {
+        this->mMapSource = true;
+    }
+
+    inline const SourceMap &source_map() const {
+        return this->mSourceMap;
+    }
+
+    std::vector<Patch> emit(std::shared_ptr<Node> root);
+
+    inline const std::string &output() const {
+        return this->mOutput;
+    }
+
+    // Number of blocks passed to the renderer by the last call to emit()
+    inline const std::size_t rendered() const {
+        return this->mRendered;
+    }
+};
+
+} // namespace louvre
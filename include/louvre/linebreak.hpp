@@ -0,0 +1,94 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace louvre {
+enum class BreakMode { Greedy, TotalFit };
+
+// Words [first, last) of a paragraph laid out on one line, separated by
+// single spaces
+class Line {
+    private:
+    const std::size_t mFirst;
+    const std::size_t mLast;
+    const std::size_t mWidth;
+
+    public:
+    Line(std::size_t first, std::size_t last, std::size_t width)
+        : mFirst(first), mLast(last), mWidth(width) {};
+
+    inline const std::size_t first() const {
+        return this->mFirst;
+    }
+
+    inline const std::size_t last() const {
+        return this->mLast;
+    }
+
+    inline const std::size_t width() const {
+        return this->mWidth;
+    }
+};
+
+// Breaks paragraphs into lines of a given display width. Greedy mode fills
+// each line as much as possible. TotalFit mode minimizes the sum of the
+// squared slack of all lines but the last one over the whole paragraph, in
+// amortized linear time. Word widths are cached, so a single instance should
+// be reused for all paragraphs of a document
+class LineBreaker {
+    private:
+    class WordHash {
+        public:
+        using is_transparent = void;
+
+        inline std::size_t operator()(std::string_view word) const {
+            return std::hash<std::string_view>{}(word);
+        }
+    };
+
+    std::unordered_map<std::string, std::size_t, WordHash, std::equal_to<>>
+        mWidths;
+
+    public:
+    std::size_t word_width(std::string_view word);
+
+    std::vector<Line> break_words(const std::vector<std::string_view> &words,
+                                  std::size_t                          width,
+                                  BreakMode                            mode);
+
+    // Breaks the text and pads every line but the last one to exactly width
+    // columns by spreading spaces between words
+    std::vector<std::string> justify(std::string_view text,
+                                     std::size_t      width,
+                                     BreakMode mode = BreakMode::TotalFit);
+
+    static std::vector<std::string_view> split_words(std::string_view text);
+
+    private:
+    std::vector<Line> break_greedy(const std::vector<std::size_t> &widths,
+                                   std::size_t                     width);
+    std::vector<Line> break_total_fit(const std::vector<std::size_t> &widths,
+                                      std::size_t                     width);
+};
+
+} // namespace louvre
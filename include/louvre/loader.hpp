@@ -0,0 +1,69 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace louvre {
+// Reads many files at once and passes each file to a callback as soon as it
+// has been read, so that parsing a file overlaps with reading the others. On
+// Linux, reads are submitted in batches through io_uring. Elsewhere, or if
+// io_uring is not available, each worker thread reads files on its own
+class FileLoader {
+    public:
+    // Called once per file on one of the worker threads, with the contents
+    // of the file or std::nullopt if it cannot be read. Callbacks for
+    // different files run concurrently
+    using Callback = std::function<void(const std::string         &path,
+                                        std::optional<std::string> content)>;
+
+    private:
+    class Queue;
+
+    const std::size_t mThreads;
+    const unsigned    mQueueDepth;
+    bool              mTryUring;
+    bool              mUsedUring;
+
+    public:
+    // Zero threads means one per hardware thread. The queue depth is the
+    // maximum number of reads in flight through io_uring
+    FileLoader(std::size_t threads = 0, unsigned queue_depth = 64);
+
+    // Returns once every callback has returned
+    void load(const std::vector<std::string> &paths, Callback callback);
+
+    // Reads files with worker threads only
+    inline void disable_io_uring() {
+        this->mTryUring = false;
+    }
+
+    // Whether the last call to load() read the files through io_uring
+    inline bool used_io_uring() const {
+        return this->mUsedUring;
+    }
+
+    private:
+    bool load_uring(const std::vector<std::string> &paths,
+                    const Callback                 &callback,
+                    Queue                          &queue) const;
+};
+
+} // namespace louvre
@@ -0,0 +1,173 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+// C interface to the parser. A parsed document is walked through the
+// preorder indices of its nodes, and every string it returns points into
+// memory owned by the document, so callers can read the whole tree without
+// copying or allocating. Pointers stay valid until the document is freed
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(LOUVRE_BUILD_C_API)
+#define LOUVRE_API __declspec(dllexport)
+#elif defined(_WIN32)
+#define LOUVRE_API __declspec(dllimport)
+#else
+#define LOUVRE_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct louvre_document louvre_document;
+
+// Preorder index of a node. The root is node 0, and the descendants of node
+// n are the nodes in [n + 1, louvre_node_subtree_end(n))
+typedef uint32_t louvre_node;
+
+#define LOUVRE_NO_NODE ((louvre_node)UINT32_MAX)
+
+// Not null-terminated. Empty strings may have a null data pointer
+typedef struct louvre_string {
+    const char *data;
+    size_t      length;
+} louvre_string;
+
+typedef enum louvre_status {
+    LOUVRE_OK,
+    LOUVRE_SYNTAX_ERROR,
+    LOUVRE_TAG_ERROR,
+    LOUVRE_NODE_ERROR,
+    LOUVRE_CANCELLED,
+    LOUVRE_LIMIT_EXCEEDED
+} louvre_status;
+
+// Same order as louvre::StandardNodeType. Nodes created by custom tag
+// bindings are LOUVRE_TYPE_CUSTOM
+typedef enum louvre_type {
+    LOUVRE_TYPE_ROOT,
+    LOUVRE_TYPE_LEFT,
+    LOUVRE_TYPE_CENTER,
+    LOUVRE_TYPE_RIGHT,
+    LOUVRE_TYPE_JUSTIFY,
+    LOUVRE_TYPE_PARAGRAPH,
+    LOUVRE_TYPE_NUMBERS,
+    LOUVRE_TYPE_BULLETS,
+    LOUVRE_TYPE_ITEM,
+    LOUVRE_TYPE_TEXT,
+    LOUVRE_TYPE_LINE_BREAK,
+    LOUVRE_TYPE_NULL,
+    LOUVRE_TYPE_GROUP,
+    LOUVRE_TYPE_LABEL,
+    LOUVRE_TYPE_REFERENCE,
+    LOUVRE_TYPE_CUSTOM = 255
+} louvre_type;
+
+// Parses length bytes of source with the standard tags. The path, which may
+// be null, is used to resolve #include and is reported in errors. The
+// source is not referenced after the call returns. Returns null only if
+// memory runs out; errors are reported through louvre_document_status()
+LOUVRE_API louvre_document *
+louvre_parse(const char *source, size_t length, const char *path);
+
+LOUVRE_API void louvre_document_free(louvre_document *document);
+
+LOUVRE_API louvre_status
+louvre_document_status(const louvre_document *document);
+
+// Message of the error that stopped parsing, empty on success
+LOUVRE_API louvre_string
+louvre_document_error(const louvre_document *document);
+
+// Zero-based line and column of the error. Returns 0 if the error has no
+// location
+LOUVRE_API int louvre_document_error_location(const louvre_document *document,
+                                              size_t                *line,
+                                              size_t                *column);
+
+// Number of nodes, zero if parsing failed. Node arguments of the functions
+// below must be less than this
+LOUVRE_API size_t louvre_document_size(const louvre_document *document);
+
+LOUVRE_API louvre_type louvre_node_type(const louvre_document *document,
+                                        louvre_node            node);
+
+// Type name of custom nodes, empty for standard ones
+LOUVRE_API louvre_string louvre_node_type_name(const louvre_document *document,
+                                               louvre_node            node);
+
+// The root is its own parent
+LOUVRE_API louvre_node louvre_node_parent(const louvre_document *document,
+                                          louvre_node            node);
+
+LOUVRE_API uint32_t louvre_node_depth(const louvre_document *document,
+                                      louvre_node            node);
+
+LOUVRE_API louvre_node louvre_node_subtree_end(const louvre_document *document,
+                                               louvre_node            node);
+
+// Children of the node, in order, as a contiguous array of *count nodes
+LOUVRE_API const louvre_node *
+louvre_node_children(const louvre_document *document,
+                     louvre_node            node,
+                     size_t                *count);
+
+// LOUVRE_NO_NODE if the node has n children or fewer
+LOUVRE_API louvre_node louvre_node_child(const louvre_document *document,
+                                         louvre_node            node,
+                                         size_t                 n);
+
+// Contents of text nodes, empty for other nodes
+LOUVRE_API louvre_string louvre_node_text(const louvre_document *document,
+                                          louvre_node            node);
+
+// Position of the node among the children of its parent
+LOUVRE_API size_t louvre_node_number(const louvre_document *document,
+                                     louvre_node            node);
+
+// Byte range [*start, *end) of the source the node was parsed from
+LOUVRE_API void louvre_node_source_range(const louvre_document *document,
+                                         louvre_node            node,
+                                         size_t                *start,
+                                         size_t                *end);
+
+// Innermost node whose source range contains the byte offset, or
+// LOUVRE_NO_NODE
+LOUVRE_API louvre_node louvre_node_at(const louvre_document *document,
+                                      size_t                 offset);
+
+// Name of the tag that created the node, empty if there is none
+LOUVRE_API louvre_string louvre_node_tag(const louvre_document *document,
+                                         louvre_node            node);
+
+LOUVRE_API size_t louvre_node_argument_count(const louvre_document *document,
+                                             louvre_node            node);
+
+// Empty if the tag has n arguments or fewer
+LOUVRE_API louvre_string louvre_node_argument(const louvre_document *document,
+                                              louvre_node            node,
+                                              size_t                 n);
+
+// Label targeted by a #ref node, or LOUVRE_NO_NODE
+LOUVRE_API louvre_node louvre_node_reference(const louvre_document *document,
+                                             louvre_node            node);
+
+#ifdef __cplusplus
+}
+#endif
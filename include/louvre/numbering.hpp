@@ -0,0 +1,106 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <louvre/api.hpp>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace louvre {
+enum class NumberStyle {
+    Decimal,
+    LowerAlpha,
+    UpperAlpha,
+    LowerRoman,
+    UpperRoman
+};
+
+// Computes hierarchical numbers (1, 1.1, 1.1.a, ...) for counted nodes in a
+// single pass over the tree. A counter counts the nodes of a given type: if
+// it has a scope, only nodes whose parent has the scope type are counted and
+// each scope node restarts the count. Counted nodes nested in another node
+// counted by the same counter get the number of that node as prefix.
+// #item nodes inside #numbers are counted by default
+class Numbering {
+    private:
+    class Counter {
+        public:
+        std::variant<StandardNodeType, std::string>                mType;
+        std::optional<std::variant<StandardNodeType, std::string>> mScope;
+    };
+
+    class Level {
+        public:
+        std::uint32_t mCount;
+        std::uint32_t mPrefixOffset;
+        std::uint32_t mPrefixLength;
+    };
+
+    std::vector<Counter>       mCounters;
+    std::vector<std::uint32_t> mValues;
+    std::unordered_map<const Node *, std::pair<std::uint32_t, std::uint32_t>>
+        mRanges;
+
+    public:
+    Numbering();
+
+    inline void add_counter(
+        std::variant<StandardNodeType, std::string>                type,
+        std::optional<std::variant<StandardNodeType, std::string>> scope =
+            std::nullopt) {
+        this->mCounters.push_back(Counter{type, scope});
+    }
+
+    void compute(std::shared_ptr<Node> root);
+
+    // Number of the node, one value per level, or an empty span if no
+    // counter counted the node
+    inline const std::span<const std::uint32_t>
+    of(const std::shared_ptr<Node> &node) const {
+        auto it = this->mRanges.find(node.get());
+
+        if (this->mRanges.end() == it) {
+            return {};
+        }
+
+        return std::span<const std::uint32_t>(
+            this->mValues.data() + it->second.first, it->second.second);
+    }
+
+    // Renders the number of the node using one style per level. Levels
+    // deeper than the list of styles reuse the last style
+    std::string format(const std::shared_ptr<Node> &node,
+                       const std::vector<NumberStyle> &styles =
+                           {NumberStyle::Decimal,
+                            NumberStyle::Decimal,
+                            NumberStyle::LowerAlpha},
+                       const std::string &separator = ".") const;
+
+    private:
+    void visit(const std::shared_ptr<Node>                       &node,
+               const std::variant<StandardNodeType, std::string> &parent_type,
+               std::vector<std::vector<Level>>                   &levels);
+};
+
+} // namespace louvre
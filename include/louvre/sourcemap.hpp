@@ -0,0 +1,99 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace louvre {
+// Maps positions in an emitter's output back to positions in the louvre
+// source and vice versa. Emitters add one mapping at each node boundary and
+// text span start, in increasing output order. Mappings are stored as
+// varint deltas, with a checkpoint every few entries so that lookups only
+// decode a short run after a binary search
+class SourceMap {
+    private:
+    // Position of the first mapping of a run in the encoded bytes, the
+    // mapping preceding it (deltas are relative to it) and its own output
+    // offset, which is what lookups search by
+    class Checkpoint {
+        public:
+        std::size_t mByte;
+        std::size_t mPreviousOutput;
+        std::size_t mPreviousSource;
+        std::size_t mOutput;
+    };
+
+    std::vector<std::uint8_t> mBytes;
+    std::vector<Checkpoint>   mCheckpoints;
+    std::size_t               mCount;
+    std::size_t               mLastOutput;
+    std::size_t               mLastSource;
+
+    // Pairs of (source, output) sorted by source, built by finalize() and
+    // dropped by add()
+    std::vector<std::pair<std::size_t, std::size_t>> mBySource;
+
+    public:
+    SourceMap() : mCount(0), mLastOutput(0), mLastSource(0) {};
+
+    // Output offsets must not decrease from one call to the next
+    void add(std::size_t output_offset, std::size_t source_offset);
+
+    void clear();
+
+    // Builds the source-ordered index used by to_output(). Call it once all
+    // mappings are added; until then to_output() decodes the whole map
+    void finalize();
+
+    // Source offset of the last mapping at or before the output offset
+    const std::optional<std::size_t> to_source(std::size_t output_offset) const;
+
+    // Output offset of the last mapping at or before the source offset
+    const std::optional<std::size_t> to_output(std::size_t source_offset) const;
+
+    inline const std::size_t size() const {
+        return this->mCount;
+    }
+
+    // Encoded size in bytes, excluding checkpoints
+    inline const std::size_t encoded_size() const {
+        return this->mBytes.size();
+    }
+
+    // Calls the visitor with every (output, source) pair, in output order
+    template <class Visitor> void for_each(Visitor visitor) const {
+        std::size_t byte   = 0;
+        std::size_t output = 0;
+        std::size_t source = 0;
+
+        for (std::size_t i = 0; i < this->mCount; i++) {
+            this->decode(byte, output, source);
+            visitor(output, source);
+        }
+    }
+
+    private:
+    void push_varint(std::uint64_t value);
+    void decode(std::size_t &byte,
+                std::size_t &output,
+                std::size_t &source) const;
+};
+
+} // namespace louvre
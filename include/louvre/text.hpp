@@ -0,0 +1,70 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <louvre/api.hpp>
+#include <louvre/linebreak.hpp>
+#include <louvre/numbering.hpp>
+#include <louvre/sourcemap.hpp>
+#include <memory>
+#include <string>
+
+namespace louvre {
+// Renders a tree as plain text lines of a fixed display width. Text runs up
+// to the next line break or block are laid out as one paragraph, aligned by
+// the innermost #left, #center, #right or #justify block. #paragraph indents
+// its content, and #item is marked with a bullet or with its number. The
+// bullet is the argument of the enclosing #bullets, "-" by default. It is
+// carried down the traversal rather than read from the parent of each item,
+// since the items of an edited tree may be shared with other versions.
+//
+// If given a source map, emit() refills it with the output offset of each
+// block and of each text run, mapped to the source offset of the node they
+// start with
+class TextEmitter {
+    private:
+    const std::size_t mWidth;
+    const BreakMode   mMode;
+    LineBreaker       mBreaker;
+    Numbering         mNumbering;
+    std::string       mOutput;
+    std::string       mRun;
+    std::string       mMarker;
+    std::string       mBullet;
+    std::size_t       mIndent;
+    std::size_t       mRunSource;
+    StandardNodeType  mAlign;
+    SourceMap *const  mSourceMap;
+
+    public:
+    TextEmitter(std::size_t width      = 80,
+                BreakMode   mode       = BreakMode::TotalFit,
+                SourceMap  *source_map = nullptr)
+        : mWidth(width), mMode(mode), mIndent(0), mRunSource(0),
+          mAlign(StandardNodeType::Left), mSourceMap(source_map) {};
+
+    std::string emit(std::shared_ptr<Node> root);
+
+    private:
+    void visit(const std::shared_ptr<Node> &node);
+    void visit_children(const std::shared_ptr<Node> &node);
+    void open(const std::shared_ptr<Node> &node);
+    void mark(std::size_t source);
+    void flush();
+};
+
+} // namespace louvre
@@ -0,0 +1,30 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace louvre {
+// Number of terminal columns taken by a codepoint: 0 for control characters
+// and combining marks, 2 for wide CJK characters and emoji, 1 otherwise
+std::size_t codepoint_width(char32_t codepoint);
+
+// Number of terminal columns taken by a UTF-8 string. Runs of printable ASCII
+// are counted 8 bytes at a time. Invalid UTF-8 bytes count as one column each
+std::size_t display_width(std::string_view text);
+
+} // namespace louvre
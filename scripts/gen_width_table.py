@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+# Copyright 2025 Alessandro Salerno
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+# Generates src/width_table.hpp, the two-level display width table used by
+# src/width.cpp. Run it from the root of the repository:
+#     python3 scripts/gen_width_table.py > src/width_table.hpp
+
+import unicodedata
+
+BLOCK_SIZE = 256
+MAX_CODEPOINT = 0x110000
+
+# Unassigned codepoints in these ranges are reserved for wide ideographs
+WIDE_RANGES = [
+    (0x3400, 0x4DBF),
+    (0x4E00, 0x9FFF),
+    (0xF900, 0xFAFF),
+    (0x20000, 0x2FFFD),
+    (0x30000, 0x3FFFD),
+]
+
+
+def width(cp):
+    c = chr(cp)
+    category = unicodedata.category(c)
+
+    if category in ("Cc", "Cs"):
+        return 0
+
+    if cp == 0x00AD:
+        return 1
+
+    if category in ("Mn", "Me", "Cf"):
+        return 0
+
+    # Hangul medial vowels and final consonants combine with the initial
+    if 0x1160 <= cp <= 0x11FF or 0xD7B0 <= cp <= 0xD7FF:
+        return 0
+
+    if unicodedata.east_asian_width(c) in ("W", "F"):
+        return 2
+
+    if category == "Cn":
+        for first, last in WIDE_RANGES:
+            if first <= cp <= last:
+                return 2
+
+    return 1
+
+
+def main():
+    blocks = []
+    block_ids = {}
+    stage1 = []
+
+    for base in range(0, MAX_CODEPOINT, BLOCK_SIZE):
+        packed = bytearray(BLOCK_SIZE // 4)
+
+        for i in range(BLOCK_SIZE):
+            packed[i // 4] |= width(base + i) << ((i % 4) * 2)
+
+        packed = bytes(packed)
+        if packed not in block_ids:
+            block_ids[packed] = len(blocks)
+            blocks.append(packed)
+
+        stage1.append(block_ids[packed])
+
+    assert len(blocks) <= 256
+
+    print("// Generated by scripts/gen_width_table.py from Unicode "
+          + unicodedata.unidata_version + ", do not edit")
+    print()
+    print("#pragma once")
+    print()
+    print("#include <cstdint>")
+    print()
+    print("namespace louvre {")
+    print("// Index of the width block of each group of %d codepoints"
+          % BLOCK_SIZE)
+    print("static const std::uint8_t WIDTH_STAGE1[%d] = {" % len(stage1))
+    for i in range(0, len(stage1), 12):
+        row = ", ".join("%3d" % x for x in stage1[i:i + 12])
+        print("    " + row + ",")
+    print("};")
+    print()
+    print("// Width blocks, 2 bits per codepoint, lowest bits first")
+    print("static const std::uint8_t WIDTH_STAGE2[%d][%d] = {"
+          % (len(blocks), BLOCK_SIZE // 4))
+    for block in blocks:
+        print("    {")
+        for i in range(0, len(block), 12):
+            row = ", ".join("0x%02x" % x for x in block[i:i + 12])
+            print("        " + row + ",")
+        print("    },")
+    print("};")
+    print()
+    print("} // namespace louvre")
+
+
+if __name__ == "__main__":
+    main()
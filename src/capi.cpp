@@ -0,0 +1,241 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <louvre/api.hpp>
+#include <louvre/document.hpp>
+#include <louvre/louvre.h>
+#include <memory>
+#include <new>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+static_assert(std::is_same_v<louvre_node, louvre::NodeIndex>);
+static_assert(LOUVRE_NO_NODE == louvre::NodeIndex(-1));
+static_assert(LOUVRE_TYPE_ROOT ==
+              static_cast<int>(louvre::StandardNodeType::Root));
+static_assert(LOUVRE_TYPE_REFERENCE ==
+              static_cast<int>(louvre::StandardNodeType::Reference));
+
+// Holds the tree, so that strings returned to callers stay valid
+struct louvre_document {
+    std::optional<louvre::Document>       mDocument;
+    louvre_status                         mStatus;
+    std::string                           mError;
+    std::optional<louvre::SourceLocation> mLocation;
+};
+
+static inline louvre_string to_c(const std::string &string) {
+    return louvre_string{string.data(), string.size()};
+}
+
+static inline const louvre::Node &node_of(const louvre_document *document,
+                                          louvre_node            node) {
+    return *document->mDocument->node(node);
+}
+
+extern "C" {
+louvre_document *
+louvre_parse(const char *source, size_t length, const char *path) {
+    auto *document = new (std::nothrow) louvre_document{
+        std::nullopt, LOUVRE_OK, std::string(), std::nullopt};
+
+    if (nullptr == document) {
+        return nullptr;
+    }
+
+    // Nothing may unwind into C code
+    try {
+        auto parser =
+            louvre::Parser(std::string(source, length),
+                           (nullptr != path) ? path : std::string());
+        auto res = parser.parse();
+
+        using Root = std::shared_ptr<louvre::Node>;
+
+        if (const auto root = std::get_if<Root>(&res)) {
+            document->mDocument.emplace(*root);
+        } else if (const auto e = std::get_if<louvre::SyntaxError>(&res)) {
+            document->mStatus = LOUVRE_SYNTAX_ERROR;
+            document->mError  = e->message();
+            document->mLocation.emplace(e->location());
+        } else if (const auto e = std::get_if<louvre::TagError>(&res)) {
+            document->mStatus = LOUVRE_TAG_ERROR;
+            document->mError  = e->message();
+            document->mLocation.emplace(e->tag()->location());
+        } else if (const auto e = std::get_if<louvre::NodeError>(&res)) {
+            document->mStatus = LOUVRE_NODE_ERROR;
+            document->mError  = e->message();
+
+            if (const auto tag = e->node()->tag()) {
+                document->mLocation.emplace((*tag)->location());
+            }
+        } else if (const auto e = std::get_if<louvre::CancelledError>(&res)) {
+            document->mStatus = LOUVRE_CANCELLED;
+            document->mError  = "Cancelled";
+            document->mLocation.emplace(e->location());
+        } else if (const auto e = std::get_if<louvre::LimitError>(&res)) {
+            document->mStatus = LOUVRE_LIMIT_EXCEEDED;
+            document->mError  = e->message();
+            document->mLocation.emplace(e->location());
+        }
+    } catch (...) {
+        delete document;
+        return nullptr;
+    }
+
+    return document;
+}
+
+void louvre_document_free(louvre_document *document) {
+    delete document;
+}
+
+louvre_status louvre_document_status(const louvre_document *document) {
+    return document->mStatus;
+}
+
+louvre_string louvre_document_error(const louvre_document *document) {
+    return to_c(document->mError);
+}
+
+int louvre_document_error_location(const louvre_document *document,
+                                   size_t                *line,
+                                   size_t                *column) {
+    if (!document->mLocation) {
+        return 0;
+    }
+
+    *line   = document->mLocation->line();
+    *column = document->mLocation->column();
+    return 1;
+}
+
+size_t louvre_document_size(const louvre_document *document) {
+    return document->mDocument ? document->mDocument->size() : 0;
+}
+
+louvre_type louvre_node_type(const louvre_document *document,
+                             louvre_node            node) {
+    const auto &type = node_of(document, node).type();
+
+    if (const auto standard = std::get_if<louvre::StandardNodeType>(&type)) {
+        return static_cast<louvre_type>(*standard);
+    }
+
+    return LOUVRE_TYPE_CUSTOM;
+}
+
+louvre_string louvre_node_type_name(const louvre_document *document,
+                                    louvre_node            node) {
+    const auto &type = node_of(document, node).type();
+
+    if (const auto custom = std::get_if<std::string>(&type)) {
+        return to_c(*custom);
+    }
+
+    return louvre_string{nullptr, 0};
+}
+
+louvre_node louvre_node_parent(const louvre_document *document,
+                               louvre_node            node) {
+    return document->mDocument->parent(node);
+}
+
+uint32_t louvre_node_depth(const louvre_document *document,
+                           louvre_node            node) {
+    return document->mDocument->depth(node);
+}
+
+louvre_node louvre_node_subtree_end(const louvre_document *document,
+                                    louvre_node            node) {
+    return document->mDocument->subtree_end(node);
+}
+
+const louvre_node *louvre_node_children(const louvre_document *document,
+                                        louvre_node            node,
+                                        size_t                *count) {
+    const auto children = document->mDocument->children(node);
+    *count              = children.size();
+    return children.data();
+}
+
+louvre_node louvre_node_child(const louvre_document *document,
+                              louvre_node            node,
+                              size_t                 n) {
+    const auto children = document->mDocument->children(node);
+    return (n < children.size()) ? children[n] : LOUVRE_NO_NODE;
+}
+
+louvre_string louvre_node_text(const louvre_document *document,
+                               louvre_node            node) {
+    const auto &text = node_of(document, node).text();
+    return text ? to_c(*text) : louvre_string{nullptr, 0};
+}
+
+size_t louvre_node_number(const louvre_document *document,
+                          louvre_node            node) {
+    return node_of(document, node).number();
+}
+
+void louvre_node_source_range(const louvre_document *document,
+                              louvre_node            node,
+                              size_t                *start,
+                              size_t                *end) {
+    *start = node_of(document, node).source_start();
+    *end   = node_of(document, node).source_end();
+}
+
+louvre_node louvre_node_at(const louvre_document *document, size_t offset) {
+    if (!document->mDocument) {
+        return LOUVRE_NO_NODE;
+    }
+
+    return document->mDocument->node_at(offset).value_or(LOUVRE_NO_NODE);
+}
+
+louvre_string louvre_node_tag(const louvre_document *document,
+                              louvre_node            node) {
+    const auto tag = node_of(document, node).tag();
+    return tag ? to_c((*tag)->name()) : louvre_string{nullptr, 0};
+}
+
+size_t louvre_node_argument_count(const louvre_document *document,
+                                  louvre_node            node) {
+    const auto tag = node_of(document, node).tag();
+    return tag ? (*tag)->arguments().size() : 0;
+}
+
+louvre_string louvre_node_argument(const louvre_document *document,
+                                   louvre_node            node,
+                                   size_t                 n) {
+    const auto tag = node_of(document, node).tag();
+
+    if (!tag || n >= (*tag)->arguments().size()) {
+        return louvre_string{nullptr, 0};
+    }
+
+    return to_c((*tag)->arguments()[n]);
+}
+
+louvre_node louvre_node_reference(const louvre_document *document,
+                                  louvre_node            node) {
+    return document->mDocument->reference(node).value_or(LOUVRE_NO_NODE);
+}
+}
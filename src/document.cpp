@@ -0,0 +1,260 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <louvre/api.hpp>
+#include <louvre/document.hpp>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace louvre {
+Document::Document(std::shared_ptr<Node> root) : mRoot(root) {
+    // Iterative preorder walk: each stack entry is a node and the index of
+    // its parent. Children are pushed in reverse to be visited in order
+    std::vector<std::pair<std::shared_ptr<Node>, NodeIndex>> stack;
+    stack.push_back(std::make_pair(root, 0));
+
+    while (!stack.empty()) {
+        auto [node, parent]   = std::move(stack.back());
+        const NodeIndex index = this->mNodes.size();
+        stack.pop_back();
+
+        this->mNodes.push_back(node);
+        this->mParents.push_back(parent);
+        this->mEnds.push_back(0);
+        this->mDepths.push_back((0 == index) ? 0
+                                             : this->mDepths[parent] + 1);
+        this->mSourceStarts.push_back(node->source_start());
+        this->mSourceEnds.push_back(node->source_end());
+        this->mIndices[node.get()] = index;
+        this->mTypes[node->type()].push_back(index);
+
+        if (const auto tag = node->tag()) {
+            this->mTags[(*tag)->name()].push_back(index);
+
+            if (node->is(StandardNodeType::Label) &&
+                !(*tag)->arguments().empty()) {
+                this->mLabels.emplace((*tag)->arguments().front(), index);
+            }
+        }
+
+        const auto children = node->children();
+        for (auto it = children.rbegin(); it != children.rend(); it++) {
+            stack.push_back(std::make_pair(*it, index));
+        }
+    }
+
+    // Subtree ends: walking backwards, every node extends the subtree of
+    // its parent at least up to its own end
+    const std::size_t count = this->mNodes.size();
+    for (std::size_t i = count; i-- > 0;) {
+        this->mEnds[i] = std::max<NodeIndex>(this->mEnds[i], i + 1);
+
+        if (0 != i) {
+            NodeIndex &parent_end = this->mEnds[this->mParents[i]];
+            parent_end            = std::max(parent_end, this->mEnds[i]);
+        }
+    }
+
+    // Children lists in CSR form. Preorder visits siblings in order, so a
+    // counting sort by parent keeps each list sorted
+    this->mChildOffsets.assign(count + 1, 0);
+    for (std::size_t i = 1; i < count; i++) {
+        this->mChildOffsets[this->mParents[i] + 1]++;
+    }
+
+    for (std::size_t i = 0; i < count; i++) {
+        this->mChildOffsets[i + 1] += this->mChildOffsets[i];
+    }
+
+    std::vector<std::uint32_t> cursor(this->mChildOffsets.begin(),
+                                      this->mChildOffsets.end() - 1);
+    this->mChildren.resize(count - 1);
+    for (std::size_t i = 1; i < count; i++) {
+        this->mChildren[cursor[this->mParents[i]]++] = i;
+    }
+}
+
+const std::optional<NodeIndex>
+Document::index_of(const std::shared_ptr<Node> &node) const {
+    if (auto it = this->mIndices.find(node.get()); this->mIndices.end() != it) {
+        return it->second;
+    }
+
+    return std::nullopt;
+}
+
+const std::optional<NodeIndex> Document::nth_child(NodeIndex   index,
+                                                   std::size_t n) const {
+    const auto children = this->children(index);
+
+    if (n >= children.size()) {
+        return std::nullopt;
+    }
+
+    return children[n];
+}
+
+const std::optional<NodeIndex> Document::node_at(std::size_t offset) const {
+    if (offset < this->mSourceStarts[0] || offset >= this->mSourceEnds[0]) {
+        return std::nullopt;
+    }
+
+    NodeIndex current = 0;
+
+    while (true) {
+        // Siblings never overlap and are sorted by start offset: the only
+        // candidate is the last child starting at or before the offset
+        const auto children = this->children(current);
+        const auto next     = std::upper_bound(
+            children.begin(),
+            children.end(),
+            offset,
+            [this](std::size_t value, NodeIndex child) {
+                return value < this->mSourceStarts[child];
+            });
+
+        if (children.begin() == next) {
+            return current;
+        }
+
+        const NodeIndex child = *(next - 1);
+        if (offset >= this->mSourceEnds[child]) {
+            return current;
+        }
+
+        current = child;
+    }
+}
+
+const std::vector<NodeIndex> Document::ancestors(NodeIndex index) const {
+    std::vector<NodeIndex> buf;
+    buf.reserve(this->mDepths[index]);
+
+    while (0 != index) {
+        index = this->mParents[index];
+        buf.push_back(index);
+    }
+
+    return buf;
+}
+
+const std::optional<NodeIndex>
+Document::label(const std::string &name) const {
+    if (auto it = this->mLabels.find(name); this->mLabels.end() != it) {
+        return it->second;
+    }
+
+    return std::nullopt;
+}
+
+const std::optional<NodeIndex> Document::reference(NodeIndex index) const {
+    const auto &node = this->mNodes[index];
+    const auto  tag  = node->tag();
+
+    if (!node->is(StandardNodeType::Reference) || !tag ||
+        (*tag)->arguments().empty()) {
+        return std::nullopt;
+    }
+
+    return this->label((*tag)->arguments().front());
+}
+
+const std::span<const NodeIndex> Document::of_type(
+    const std::variant<StandardNodeType, std::string> &type) const {
+    if (auto it = this->mTypes.find(type); this->mTypes.end() != it) {
+        return it->second;
+    }
+
+    return {};
+}
+
+const std::span<const NodeIndex> Document::descendants_of_type(
+    NodeIndex                                          index,
+    const std::variant<StandardNodeType, std::string> &type) const {
+    return this->in_subtree(index, this->of_type(type));
+}
+
+const std::span<const NodeIndex>
+Document::with_tag(const std::string &name) const {
+    if (auto it = this->mTags.find(name); this->mTags.end() != it) {
+        return it->second;
+    }
+
+    return {};
+}
+
+const std::span<const NodeIndex>
+Document::descendants_with_tag(NodeIndex index, const std::string &name) const {
+    return this->in_subtree(index, this->with_tag(name));
+}
+
+FrozenDocument Document::freeze() const {
+    return FrozenDocument(*this);
+}
+
+const std::span<const NodeIndex>
+Document::in_subtree(NodeIndex                        index,
+                     const std::span<const NodeIndex> list) const {
+    const auto first = std::upper_bound(list.begin(), list.end(), index);
+    const auto last  = std::lower_bound(first, list.end(), this->mEnds[index]);
+    return list.subspan(first - list.begin(), last - first);
+}
+
+// Building the Document already loaded every lazy block, so the pointers
+// taken here never see a tree that is still changing
+FrozenDocument::FrozenDocument(const Document &document)
+    : mRoot(document.root()) {
+    const std::size_t count = document.size();
+    this->mNodes.reserve(count);
+    this->mTags.reserve(count);
+    this->mReferences.reserve(count);
+    this->mParents.reserve(count);
+    this->mEnds.reserve(count);
+    this->mDepths.reserve(count);
+    this->mChildOffsets.reserve(count + 1);
+    this->mChildren.reserve((0 == count) ? 0 : count - 1);
+
+    for (NodeIndex i = 0; i < count; i++) {
+        const auto &node = document.node(i);
+        const auto  tag  = node->tag();
+
+        // A node without a target refers to itself
+        const NodeIndex target = document.reference(i).value_or(i);
+
+        this->mNodes.push_back(node.get());
+        this->mTags.push_back(tag ? tag->get() : nullptr);
+        this->mReferences.push_back(target);
+        this->mParents.push_back(document.parent(i));
+        this->mEnds.push_back(document.subtree_end(i));
+        this->mDepths.push_back(document.depth(i));
+        this->mChildOffsets.push_back(this->mChildren.size());
+
+        const auto children = document.children(i);
+        this->mChildren.insert(
+            this->mChildren.end(), children.begin(), children.end());
+    }
+
+    this->mChildOffsets.push_back(this->mChildren.size());
+}
+
+} // namespace louvre
@@ -0,0 +1,133 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <cstddef>
+#include <louvre/api.hpp>
+#include <louvre/edit.hpp>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace louvre {
+static void adopt(const std::shared_ptr<Node> &node,
+                  const std::shared_ptr<Node> &parent,
+                  std::size_t                  index) {
+    if (!node->parent()) {
+        node->set_parent(parent);
+        node->set_number(index);
+    }
+}
+
+const std::optional<std::shared_ptr<Node>>
+TreeVersion::at(const NodePath &path) const {
+    std::shared_ptr<Node> node = this->mRoot;
+
+    for (const auto index : path) {
+        const auto children = node->children();
+
+        if (index >= children.size()) {
+            return std::nullopt;
+        }
+
+        node = children[index];
+    }
+
+    return node;
+}
+
+const std::optional<TreeVersion>
+TreeVersion::replace(const NodePath &path, std::shared_ptr<Node> node) const {
+    if (path.empty()) {
+        return TreeVersion(node);
+    }
+
+    if (!this->at(path)) {
+        return std::nullopt;
+    }
+
+    const NodePath above(path.begin(), path.end() - 1);
+    const auto     copies   = this->copy_path(above);
+    const auto    &parent   = copies.back();
+    auto           children = parent->children();
+
+    children[path.back()] = node;
+    adopt(node, parent, path.back());
+    parent->set_children(std::move(children));
+    return TreeVersion(copies.front());
+}
+
+const std::optional<TreeVersion>
+TreeVersion::insert(const NodePath       &parent,
+                    std::size_t           index,
+                    std::shared_ptr<Node> node) const {
+    const auto target = this->at(parent);
+
+    if (!target || index > (*target)->children().size()) {
+        return std::nullopt;
+    }
+
+    const auto  copies   = this->copy_path(parent);
+    const auto &copy     = copies.back();
+    auto        children = copy->children();
+
+    children.insert(children.begin() + index, node);
+    adopt(node, copy, index);
+    copy->set_children(std::move(children));
+    return TreeVersion(copies.front());
+}
+
+const std::optional<TreeVersion>
+TreeVersion::remove(const NodePath &path) const {
+    if (path.empty() || !this->at(path)) {
+        return std::nullopt;
+    }
+
+    const NodePath above(path.begin(), path.end() - 1);
+    const auto     copies   = this->copy_path(above);
+    const auto    &parent   = copies.back();
+    auto           children = parent->children();
+
+    children.erase(children.begin() + path.back());
+    parent->set_children(std::move(children));
+    return TreeVersion(copies.front());
+}
+
+// Each copy takes the place of the original in the child list of the copy
+// above it. Siblings off the path are shared, and keep the original as
+// their parent
+std::vector<std::shared_ptr<Node>>
+TreeVersion::copy_path(const NodePath &path) const {
+    std::vector<std::shared_ptr<Node>> copies = {this->mRoot->copy()};
+
+    for (const auto index : path) {
+        const auto &parent   = copies.back();
+        auto        children = parent->children();
+
+        if (index >= children.size()) {
+            return {};
+        }
+
+        auto child = children[index]->copy();
+        child->set_parent(parent);
+        children[index] = child;
+        parent->set_children(std::move(children));
+        copies.push_back(std::move(child));
+    }
+
+    return copies;
+}
+
+} // namespace louvre
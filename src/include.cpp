@@ -0,0 +1,334 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <louvre/api.hpp>
+#include <louvre/include.hpp>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace louvre {
+static std::optional<IncludeCache::Result>
+load(const std::string &path, const IncludeCache::Loader &loader) {
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file) {
+        return std::nullopt;
+    }
+
+    std::string source((std::istreambuf_iterator<char>(file)),
+                       std::istreambuf_iterator<char>());
+
+    if (file.bad()) {
+        return std::nullopt;
+    }
+
+    return loader(std::move(source));
+}
+
+IncludeCache::IncludeCache()
+    : mParses(0), mInFlight(0),
+      mMaxInFlight(std::max(1u, std::thread::hardware_concurrency())),
+      mNextWorker(0) {
+}
+
+// Parsers join the threads they start before returning, so any thread left
+// here is the one dropping the last reference to the cache as it finishes
+IncludeCache::~IncludeCache() {
+    for (auto &[id, worker] : this->mWorkers) {
+        if (std::this_thread::get_id() == worker.get_id()) {
+            worker.detach();
+        } else {
+            worker.join();
+        }
+    }
+}
+
+const std::optional<std::size_t> IncludeCache::prefetch(
+    const std::string &path, const std::string &config, Loader loader) {
+    const auto time = this->modified(path);
+
+    if (!time) {
+        return std::nullopt;
+    }
+
+    std::promise<std::optional<Result>> promise;
+    std::lock_guard<std::mutex>         lock(this->mMutex);
+
+    if (this->mInFlight >= this->mMaxInFlight ||
+        this->is_hit(path, *time, config)) {
+        return std::nullopt;
+    }
+
+    this->mParses++;
+    this->mInFlight++;
+    this->mEntries[path] =
+        Entry{*time, this->mParses, promise.get_future().share(), {}, config};
+
+    // Kept as a thread rather than a future: the loader holds the cache,
+    // which would otherwise keep itself alive through the stored future
+    std::thread worker([this,
+                        path    = path,
+                        loader  = std::move(loader),
+                        promise = std::move(promise)]() mutable {
+        promise.set_value(load(path, loader));
+
+        std::lock_guard<std::mutex> lock(this->mMutex);
+        this->mInFlight--;
+    });
+
+    const std::size_t id = this->mNextWorker++;
+    this->mWorkers.emplace(id, std::move(worker));
+    return id;
+}
+
+void IncludeCache::join(std::size_t worker) {
+    std::thread thread;
+
+    {
+        std::lock_guard<std::mutex> lock(this->mMutex);
+        auto                        it = this->mWorkers.find(worker);
+
+        if (this->mWorkers.end() == it) {
+            return;
+        }
+
+        thread = std::move(it->second);
+        this->mWorkers.erase(it);
+    }
+
+    thread.join();
+}
+
+const std::shared_future<std::optional<IncludeCache::Result>>
+IncludeCache::get(const std::string &waiter,
+                  const std::string &path,
+                  const std::string &config,
+                  Loader             loader) {
+    const auto                          time = this->modified(path);
+    std::promise<std::optional<Result>> promise;
+
+    if (!time) {
+        promise.set_value(std::nullopt);
+        return promise.get_future().share();
+    }
+
+    std::shared_future<std::optional<Result>> result;
+    bool                                      owner = false;
+
+    {
+        std::lock_guard<std::mutex> lock(this->mMutex);
+
+        if (!this->is_hit(path, *time, config)) {
+            this->mParses++;
+            this->mEntries[path] = Entry{*time,
+                                         this->mParses,
+                                         promise.get_future().share(),
+                                         {},
+                                         config};
+            owner = true;
+        }
+
+        const Entry &entry = this->mEntries.at(path);
+        result             = entry.mResult;
+
+        // The includer depends on this version of the file, and goes stale
+        // as soon as the file is parsed again
+        if (auto it = this->mEntries.find(waiter); this->mEntries.end() != it) {
+            it->second.mIncludes.push_back(
+                std::make_pair(path, entry.mGeneration));
+        }
+    }
+
+    if (owner) {
+        promise.set_value(load(path, loader));
+    }
+
+    return result;
+}
+
+bool IncludeCache::begin_wait(const std::string &waiter,
+                              const std::string &path) {
+    std::lock_guard<std::mutex> lock(this->mMutex);
+
+    // Follow the files path is waiting for, transitively
+    std::vector<std::string> pending = {path};
+    std::vector<std::string> seen;
+
+    while (!pending.empty()) {
+        const std::string file = std::move(pending.back());
+        pending.pop_back();
+
+        if (file == waiter) {
+            return false;
+        }
+
+        if (seen.end() != std::find(seen.begin(), seen.end(), file)) {
+            continue;
+        }
+
+        const auto [first, last] = this->mWaits.equal_range(file);
+        for (auto it = first; it != last; it++) {
+            pending.push_back(it->second);
+        }
+
+        seen.push_back(file);
+    }
+
+    this->mWaits.emplace(waiter, path);
+    return true;
+}
+
+void IncludeCache::end_wait(const std::string &waiter,
+                            const std::string &path) {
+    std::lock_guard<std::mutex> lock(this->mMutex);
+
+    const auto [first, last] = this->mWaits.equal_range(waiter);
+    for (auto it = first; it != last; it++) {
+        if (path == it->second) {
+            this->mWaits.erase(it);
+            return;
+        }
+    }
+}
+
+std::size_t IncludeCache::parses() {
+    std::lock_guard<std::mutex> lock(this->mMutex);
+    return this->mParses;
+}
+
+bool IncludeCache::is_fresh(const std::string &path) {
+    const auto time = this->modified(path);
+
+    if (!time) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(this->mMutex);
+    std::vector<std::string>    seen;
+    return this->is_fresh(path, *time, seen);
+}
+
+const std::optional<std::size_t>
+IncludeCache::version(const std::string &path) {
+    const auto time = this->modified(path);
+
+    if (!time) {
+        return std::nullopt;
+    }
+
+    std::lock_guard<std::mutex> lock(this->mMutex);
+    std::vector<std::string>    seen;
+
+    if (!this->is_fresh(path, *time, seen)) {
+        return std::nullopt;
+    }
+
+    return this->mEntries.at(path).mGeneration;
+}
+
+const std::vector<std::string>
+IncludeCache::includes_of(const std::string &path) {
+    std::lock_guard<std::mutex> lock(this->mMutex);
+    std::vector<std::string>    pending = {path};
+    std::vector<std::string>    found;
+
+    while (!pending.empty()) {
+        const std::string file = std::move(pending.back());
+        pending.pop_back();
+        auto it = this->mEntries.find(file);
+
+        if (this->mEntries.end() == it) {
+            continue;
+        }
+
+        for (const auto &include : it->second.mIncludes) {
+            if (path != include.first &&
+                found.end() ==
+                    std::find(found.begin(), found.end(), include.first)) {
+                found.push_back(include.first);
+                pending.push_back(include.first);
+            }
+        }
+    }
+
+    return found;
+}
+
+const std::optional<std::filesystem::file_time_type>
+IncludeCache::modified(const std::string &path) const {
+    std::error_code ec;
+    const auto      time = std::filesystem::last_write_time(path, ec);
+
+    if (ec) {
+        return std::nullopt;
+    }
+
+    return time;
+}
+
+// Whether the cached tree of the file may be used by a loader with the
+// given config. Files it includes were parsed with the same config
+bool IncludeCache::is_hit(const std::string                     &path,
+                          const std::filesystem::file_time_type &time,
+                          const std::string                     &config) const {
+    std::vector<std::string> seen;
+    auto                     it = this->mEntries.find(path);
+    return this->mEntries.end() != it && config == it->second.mConfig &&
+           this->is_fresh(path, time, seen);
+}
+
+bool IncludeCache::is_fresh(const std::string                     &path,
+                            const std::filesystem::file_time_type &time,
+                            std::vector<std::string>              &seen) const {
+    auto it = this->mEntries.find(path);
+
+    if (this->mEntries.end() == it || time != it->second.mTime) {
+        return false;
+    }
+
+    // Files that include each other only hold errors, and are checked once
+    if (seen.end() != std::find(seen.begin(), seen.end(), path)) {
+        return true;
+    }
+
+    seen.push_back(path);
+
+    for (const auto &[include, generation] : it->second.mIncludes) {
+        const auto include_time = this->modified(include);
+        auto       include_it   = this->mEntries.find(include);
+
+        if (!include_time || this->mEntries.end() == include_it ||
+            generation != include_it->second.mGeneration ||
+            !this->is_fresh(include, *include_time, seen)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace louvre
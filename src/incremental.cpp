@@ -0,0 +1,141 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <louvre/api.hpp>
+#include <louvre/incremental.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace louvre {
+std::vector<Patch> IncrementalEmitter::emit(std::shared_ptr<Node> root) {
+    // Maps the hash of each previous block to its output range, so that
+    // unchanged blocks are copied instead of rendered again, even if they
+    // moved around
+    std::unordered_map<std::size_t, const Block *> previous;
+    for (const auto &block : this->mBlocks) {
+        previous.emplace(block.mHash, &block);
+    }
+
+    std::string        output;
+    std::vector<Block> blocks;
+    output.reserve(this->mOutput.length());
+    this->mRendered = 0;
+
+    for (const auto &child : root->children()) {
+        const std::size_t hash   = child->hash();
+        const std::size_t offset = output.length();
+
+        if (auto it = previous.find(hash); previous.end() != it) {
+            output.append(this->mOutput, it->second->mOffset,
+                          it->second->mLength);
+        } else {
+            output += this->mRenderer(child);
+            this->mRendered++;
+        }
+
+        blocks.push_back(Block{
+            hash, offset, output.length() - offset, child->source_start()});
+    }
+
+    const std::size_t old_count = this->mBlocks.size();
+    const std::size_t new_count = blocks.size();
+    const std::size_t min_count = std::min(old_count, new_count);
+
+    std::size_t prefix = 0;
+    while (prefix < min_count &&
+           this->mBlocks[prefix].mHash == blocks[prefix].mHash) {
+        prefix++;
+    }
+
+    std::size_t suffix = 0;
+    while (suffix < min_count - prefix &&
+           this->mBlocks[old_count - suffix - 1].mHash ==
+               blocks[new_count - suffix - 1].mHash) {
+        suffix++;
+    }
+
+    std::vector<Patch> patches;
+
+    if (old_count == new_count) {
+        // Same shape: patch every run of changed blocks on its own
+        std::size_t i = prefix;
+        while (i < old_count - suffix) {
+            if (this->mBlocks[i].mHash == blocks[i].mHash) {
+                i++;
+                continue;
+            }
+
+            std::size_t end = i;
+            while (end < old_count - suffix &&
+                   this->mBlocks[end].mHash != blocks[end].mHash) {
+                end++;
+            }
+
+            const Block &old_last = this->mBlocks[end - 1];
+            const Block &new_last = blocks[end - 1];
+            patches.emplace_back(
+                this->mBlocks[i].mOffset,
+                old_last.mOffset + old_last.mLength - this->mBlocks[i].mOffset,
+                output.substr(blocks[i].mOffset,
+                              new_last.mOffset + new_last.mLength -
+                                  blocks[i].mOffset));
+            i = end;
+        }
+    } else {
+        // Blocks were inserted or removed: replace everything between the
+        // common prefix and suffix with a single patch. Blocks are laid out
+        // back to back, so the boundaries are the ends of the prefixes
+        const std::size_t old_start =
+            (0 == prefix) ? 0
+                          : this->mBlocks[prefix - 1].mOffset +
+                                this->mBlocks[prefix - 1].mLength;
+        const std::size_t old_end =
+            (0 == suffix) ? this->mOutput.length()
+                          : this->mBlocks[old_count - suffix].mOffset;
+        const std::size_t new_start =
+            (0 == prefix)
+                ? 0
+                : blocks[prefix - 1].mOffset + blocks[prefix - 1].mLength;
+        const std::size_t new_end =
+            (0 == suffix) ? output.length()
+                          : blocks[new_count - suffix].mOffset;
+
+        patches.emplace_back(old_start,
+                             old_end - old_start,
+                             output.substr(new_start, new_end - new_start));
+    }
+
+    this->mOutput = std::move(output);
+    this->mBlocks = std::move(blocks);
+
+    if (this->mMapSource) {
+        this->mSourceMap.clear();
+
+        for (const auto &block : this->mBlocks) {
+            this->mSourceMap.add(block.mOffset, block.mSource);
+        }
+
+        this->mSourceMap.finalize();
+    }
+
+    return patches;
+}
+
+} // namespace louvre
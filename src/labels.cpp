@@ -0,0 +1,103 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <louvre/api.hpp>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace louvre {
+// FNV-1a
+std::size_t LabelIndex::hash(const std::string &name) {
+    std::uint64_t h = 0xcbf29ce484222325ULL;
+
+    for (const char c : name) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 0x100000001b3ULL;
+    }
+
+    return static_cast<std::size_t>(h);
+}
+
+void LabelIndex::grow() {
+    std::vector<Slot> old      = std::move(this->mSlots);
+    const std::size_t capacity = old.empty() ? 16 : 2 * old.size();
+    const std::size_t mask     = capacity - 1;
+    this->mSlots               = std::vector<Slot>(capacity);
+
+    for (auto &slot : old) {
+        if (!slot.mNode) {
+            continue;
+        }
+
+        std::size_t i = slot.mHash & mask;
+        while (this->mSlots[i].mNode) {
+            i = (i + 1) & mask;
+        }
+
+        this->mSlots[i] = std::move(slot);
+    }
+}
+
+bool LabelIndex::insert(const std::string &name, std::shared_ptr<Node> node) {
+    // Keep the load factor at or below one half so that probe sequences
+    // stay short
+    if (2 * (this->mCount + 1) > this->mSlots.size()) {
+        this->grow();
+    }
+
+    const std::size_t h    = LabelIndex::hash(name);
+    const std::size_t mask = this->mSlots.size() - 1;
+    std::size_t       i    = h & mask;
+
+    while (this->mSlots[i].mNode) {
+        if (h == this->mSlots[i].mHash && name == this->mSlots[i].mName) {
+            return false;
+        }
+
+        i = (i + 1) & mask;
+    }
+
+    this->mSlots[i] = Slot{h, name, node};
+    this->mCount++;
+    return true;
+}
+
+const std::optional<std::shared_ptr<Node>>
+LabelIndex::find(const std::string &name) const {
+    if (this->mSlots.empty()) {
+        return std::nullopt;
+    }
+
+    const std::size_t h    = LabelIndex::hash(name);
+    const std::size_t mask = this->mSlots.size() - 1;
+    std::size_t       i    = h & mask;
+
+    while (this->mSlots[i].mNode) {
+        if (h == this->mSlots[i].mHash && name == this->mSlots[i].mName) {
+            return this->mSlots[i].mNode;
+        }
+
+        i = (i + 1) & mask;
+    }
+
+    return std::nullopt;
+}
+
+} // namespace louvre
@@ -0,0 +1,322 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <louvre/linebreak.hpp>
+#include <louvre/width.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace louvre {
+// Cost of a line wider than the target width, per column of excess. Large
+// enough to dominate any realistic sum of squared slacks while keeping the
+// cost function convex, which the total fit algorithm relies on
+static constexpr double OVERFLOW_PENALTY = 1e10;
+
+// Dynamic programming state of the total fit breaker. mMinima[j] is the
+// cost of the best layout of the first j words and mBreaks[j] is the first
+// word of the last line of that layout. Since the line cost is a convex
+// function of the line width, the cost matrix is totally monotone and
+// row minima can be found with SMAWK
+class TotalFit {
+    public:
+    const std::size_t        mWidth;
+    std::vector<std::size_t> mOffsets;
+    std::vector<double>      mMinima;
+    std::vector<std::size_t> mBreaks;
+
+    TotalFit(const std::vector<std::size_t> &widths, std::size_t width)
+        : mWidth(width), mOffsets(widths.size() + 1, 0),
+          mMinima(widths.size() + 1, std::numeric_limits<double>::infinity()),
+          mBreaks(widths.size() + 1, 0) {
+        for (std::size_t i = 0; i < widths.size(); i++) {
+            this->mOffsets[i + 1] = this->mOffsets[i] + widths[i];
+        }
+
+        this->mMinima[0] = 0;
+    }
+
+    inline std::size_t line_width(std::size_t i, std::size_t j) const {
+        return this->mOffsets[j] - this->mOffsets[i] + (j - i - 1);
+    }
+
+    // Cost of the best layout of the first j words ending with the line
+    // made of words [i, j)
+    inline double cost(std::size_t i, std::size_t j) const {
+        const std::size_t w = this->line_width(i, j);
+
+        if (w > this->mWidth) {
+            return this->mMinima[i] + OVERFLOW_PENALTY * (w - this->mWidth);
+        }
+
+        const double slack = this->mWidth - w;
+        return this->mMinima[i] + slack * slack;
+    }
+
+    void smawk(const std::vector<std::size_t> &rows,
+               const std::vector<std::size_t> &columns) {
+        // Reduce: drop rows that cannot hold the minimum of any column
+        std::vector<std::size_t> stack;
+        std::size_t              i = 0;
+
+        while (i < rows.size()) {
+            if (stack.empty()) {
+                stack.push_back(rows[i]);
+                i++;
+                continue;
+            }
+
+            const std::size_t c = columns[stack.size() - 1];
+            if (this->cost(stack.back(), c) < this->cost(rows[i], c)) {
+                if (stack.size() < columns.size()) {
+                    stack.push_back(rows[i]);
+                }
+
+                i++;
+            } else {
+                stack.pop_back();
+            }
+        }
+
+        if (columns.size() > 1) {
+            std::vector<std::size_t> odd;
+            for (std::size_t k = 1; k < columns.size(); k += 2) {
+                odd.push_back(columns[k]);
+            }
+
+            this->smawk(stack, odd);
+        }
+
+        // Interpolate: the minima of even columns lie between the minima of
+        // their odd neighbours
+        std::size_t r = 0;
+        std::size_t j = 0;
+
+        while (j < columns.size()) {
+            const std::size_t end = (j + 1 < columns.size())
+                                        ? this->mBreaks[columns[j + 1]]
+                                        : stack.back();
+            const double c = this->cost(stack[r], columns[j]);
+
+            if (c < this->mMinima[columns[j]]) {
+                this->mMinima[columns[j]] = c;
+                this->mBreaks[columns[j]] = stack[r];
+            }
+
+            if (stack[r] < end) {
+                r++;
+            } else {
+                j += 2;
+            }
+        }
+    }
+
+    // Online variant of SMAWK: rows only become available once the minima
+    // of the corresponding columns are known, so columns are solved in
+    // doubling windows and the window restarts whenever a later row beats
+    // the current one
+    void solve() {
+        std::size_t n      = this->mMinima.size();
+        std::size_t i      = 0;
+        std::size_t offset = 0;
+
+        while (true) {
+            const std::size_t r    = std::min<std::size_t>(n, 2ULL << i);
+            const std::size_t edge = (1ULL << i) + offset;
+
+            std::vector<std::size_t> rows;
+            std::vector<std::size_t> columns;
+            for (std::size_t k = offset; k < edge; k++) {
+                rows.push_back(k);
+            }
+            for (std::size_t k = edge; k < r + offset; k++) {
+                columns.push_back(k);
+            }
+
+            this->smawk(rows, columns);
+
+            const double x         = this->mMinima[r - 1 + offset];
+            bool         restarted = false;
+
+            for (std::size_t j = 1ULL << i; j < r - 1; j++) {
+                if (this->cost(j + offset, r - 1 + offset) <= x) {
+                    n -= j;
+                    i = 0;
+                    offset += j;
+                    restarted = true;
+                    break;
+                }
+            }
+
+            if (!restarted) {
+                if (r == n) {
+                    break;
+                }
+
+                i++;
+            }
+        }
+    }
+};
+
+static inline bool is_space(char c) {
+    return ' ' == c || '\t' == c || '\r' == c || '\n' == c;
+}
+
+std::size_t LineBreaker::word_width(std::string_view word) {
+    if (auto it = this->mWidths.find(word); this->mWidths.end() != it) {
+        return it->second;
+    }
+
+    const std::size_t width = display_width(word);
+    this->mWidths.emplace(std::string(word), width);
+    return width;
+}
+
+std::vector<std::string_view> LineBreaker::split_words(std::string_view text) {
+    std::vector<std::string_view> words;
+    std::size_t                   i = 0;
+
+    while (i < text.length()) {
+        while (i < text.length() && is_space(text[i])) {
+            i++;
+        }
+
+        const std::size_t start = i;
+        while (i < text.length() && !is_space(text[i])) {
+            i++;
+        }
+
+        if (i > start) {
+            words.push_back(text.substr(start, i - start));
+        }
+    }
+
+    return words;
+}
+
+std::vector<Line>
+LineBreaker::break_words(const std::vector<std::string_view> &words,
+                         std::size_t                          width,
+                         BreakMode                            mode) {
+    if (words.empty()) {
+        return {};
+    }
+
+    std::vector<std::size_t> widths;
+    widths.reserve(words.size());
+    for (const auto word : words) {
+        widths.push_back(this->word_width(word));
+    }
+
+    if (BreakMode::Greedy == mode) {
+        return this->break_greedy(widths, width);
+    }
+
+    return this->break_total_fit(widths, width);
+}
+
+std::vector<Line>
+LineBreaker::break_greedy(const std::vector<std::size_t> &widths,
+                          std::size_t                     width) {
+    std::vector<Line> lines;
+    std::size_t       first   = 0;
+    std::size_t       current = widths[0];
+
+    for (std::size_t i = 1; i < widths.size(); i++) {
+        if (current + 1 + widths[i] <= width) {
+            current += 1 + widths[i];
+            continue;
+        }
+
+        lines.emplace_back(first, i, current);
+        first   = i;
+        current = widths[i];
+    }
+
+    lines.emplace_back(first, widths.size(), current);
+    return lines;
+}
+
+std::vector<Line>
+LineBreaker::break_total_fit(const std::vector<std::size_t> &widths,
+                             std::size_t                     width) {
+    const std::size_t count = widths.size();
+    TotalFit          state(widths, width);
+    state.solve();
+
+    // The last line is free: pick the cheapest prefix that leaves a last
+    // line that fits. A last word wider than the line goes on its own
+    std::size_t last = count - 1;
+    for (std::size_t i = 0; i < count; i++) {
+        if (state.line_width(i, count) <= width &&
+            state.mMinima[i] < state.mMinima[last]) {
+            last = i;
+        }
+    }
+
+    std::vector<std::size_t> starts;
+    for (std::size_t i = last; i > 0; i = state.mBreaks[i]) {
+        starts.push_back(i);
+    }
+
+    starts.push_back(0);
+    std::reverse(starts.begin(), starts.end());
+
+    std::vector<Line> lines;
+    for (std::size_t k = 0; k < starts.size(); k++) {
+        const std::size_t end = (k + 1 < starts.size()) ? starts[k + 1] : count;
+        lines.emplace_back(starts[k], end, state.line_width(starts[k], end));
+    }
+
+    return lines;
+}
+
+std::vector<std::string> LineBreaker::justify(std::string_view text,
+                                              std::size_t      width,
+                                              BreakMode        mode) {
+    const auto               words = LineBreaker::split_words(text);
+    const auto               lines = this->break_words(words, width, mode);
+    std::vector<std::string> out;
+
+    for (std::size_t l = 0; l < lines.size(); l++) {
+        const Line       &line  = lines[l];
+        const std::size_t gaps  = line.last() - line.first() - 1;
+        const bool        last  = l + 1 == lines.size();
+        const std::size_t extra = (last || 0 == gaps || line.width() >= width)
+                                      ? 0
+                                      : width - line.width();
+        std::string       buf;
+
+        for (std::size_t w = line.first(); w < line.last(); w++) {
+            if (w != line.first()) {
+                const std::size_t gap = w - line.first() - 1;
+                buf.append(1 + extra / gaps + (gap < extra % gaps ? 1 : 0),
+                           ' ');
+            }
+
+            buf += words[w];
+        }
+
+        out.push_back(std::move(buf));
+    }
+
+    return out;
+}
+
+} // namespace louvre
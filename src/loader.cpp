@@ -0,0 +1,541 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <louvre/loader.hpp>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define LOUVRE_POSIX
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <atomic>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define LOUVRE_IO_URING
+#endif
+
+namespace louvre {
+// Jobs run by the worker threads, in the order they were pushed
+class FileLoader::Queue {
+    private:
+    std::mutex                        mMutex;
+    std::condition_variable           mReady;
+    std::deque<std::function<void()>> mJobs;
+    bool                              mClosed;
+
+    public:
+    Queue() : mClosed(false) {};
+
+    void push(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(this->mMutex);
+            this->mJobs.push_back(std::move(job));
+        }
+
+        this->mReady.notify_one();
+    }
+
+    // Lets the workers return once no job is left
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(this->mMutex);
+            this->mClosed = true;
+        }
+
+        this->mReady.notify_all();
+    }
+
+    void run() {
+        while (true) {
+            std::function<void()> job;
+
+            {
+                std::unique_lock<std::mutex> lock(this->mMutex);
+                this->mReady.wait(lock, [this]() {
+                    return this->mClosed || !this->mJobs.empty();
+                });
+
+                if (this->mJobs.empty()) {
+                    return;
+                }
+
+                job = std::move(this->mJobs.front());
+                this->mJobs.pop_front();
+            }
+
+            job();
+        }
+    }
+};
+
+// Files are read up to the size they had when they were opened
+static std::optional<std::string> read_file(const std::string &path) {
+#ifdef LOUVRE_POSIX
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0) {
+        return std::nullopt;
+    }
+
+    struct stat info;
+    if (0 != ::fstat(fd, &info)) {
+        ::close(fd);
+        return std::nullopt;
+    }
+
+    std::string content(info.st_size, '\0');
+    std::size_t done = 0;
+
+    while (done < content.length()) {
+        const ssize_t res = ::pread(
+            fd, content.data() + done, content.length() - done, done);
+
+        if (res < 0 && EINTR == errno) {
+            continue;
+        }
+
+        if (res < 0) {
+            ::close(fd);
+            return std::nullopt;
+        }
+
+        if (0 == res) {
+            break;
+        }
+
+        done += res;
+    }
+
+    ::close(fd);
+    content.resize(done);
+    return content;
+#else
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file) {
+        return std::nullopt;
+    }
+
+    std::string content((std::istreambuf_iterator<char>(file)),
+                        std::istreambuf_iterator<char>());
+
+    if (file.bad()) {
+        return std::nullopt;
+    }
+
+    return content;
+#endif
+}
+
+#ifdef LOUVRE_IO_URING
+// Submission and completion queues shared with the kernel, set up through
+// raw system calls so that liburing is not needed
+class Uring {
+    private:
+    int             mFd;
+    io_uring_params mParams;
+    void           *mSqRing;
+    std::size_t     mSqRingSize;
+    void           *mCqRing;
+    std::size_t     mCqRingSize;
+    io_uring_sqe   *mSqes;
+
+    public:
+    Uring()
+        : mFd(-1), mSqRing(MAP_FAILED), mSqRingSize(0), mCqRing(MAP_FAILED),
+          mCqRingSize(0), mSqes(static_cast<io_uring_sqe *>(MAP_FAILED)) {};
+
+    ~Uring() {
+        if (MAP_FAILED != this->mSqes) {
+            ::munmap(this->mSqes,
+                     this->mParams.sq_entries * sizeof(io_uring_sqe));
+        }
+
+        if (MAP_FAILED != this->mCqRing && this->mCqRing != this->mSqRing) {
+            ::munmap(this->mCqRing, this->mCqRingSize);
+        }
+
+        if (MAP_FAILED != this->mSqRing) {
+            ::munmap(this->mSqRing, this->mSqRingSize);
+        }
+
+        if (0 <= this->mFd) {
+            ::close(this->mFd);
+        }
+    }
+
+    bool open(unsigned entries) {
+        std::memset(&this->mParams, 0, sizeof(this->mParams));
+        this->mFd = ::syscall(__NR_io_uring_setup, entries, &this->mParams);
+
+        if (this->mFd < 0) {
+            return false;
+        }
+
+        const io_uring_params &params = this->mParams;
+        this->mSqRingSize =
+            params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        this->mCqRingSize =
+            params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+        // Both rings share a single mapping on kernels newer than 5.4
+        const bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) {
+            this->mSqRingSize = std::max(this->mSqRingSize, this->mCqRingSize);
+        }
+
+        this->mSqRing = ::mmap(nullptr,
+                               this->mSqRingSize,
+                               PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_POPULATE,
+                               this->mFd,
+                               IORING_OFF_SQ_RING);
+
+        if (MAP_FAILED == this->mSqRing) {
+            return false;
+        }
+
+        this->mCqRing = single ? this->mSqRing
+                               : ::mmap(nullptr,
+                                        this->mCqRingSize,
+                                        PROT_READ | PROT_WRITE,
+                                        MAP_SHARED | MAP_POPULATE,
+                                        this->mFd,
+                                        IORING_OFF_CQ_RING);
+
+        if (MAP_FAILED == this->mCqRing) {
+            return false;
+        }
+
+        this->mSqes = static_cast<io_uring_sqe *>(
+            ::mmap(nullptr,
+                   params.sq_entries * sizeof(io_uring_sqe),
+                   PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE,
+                   this->mFd,
+                   IORING_OFF_SQES));
+        return MAP_FAILED != this->mSqes;
+    }
+
+    inline unsigned entries() const {
+        return this->mParams.sq_entries;
+    }
+
+    // Queues a read without submitting it. The caller makes sure that the
+    // ring has room for it
+    void prepare_read(int           fd,
+                      char         *buffer,
+                      unsigned      length,
+                      std::uint64_t offset,
+                      std::uint64_t data) {
+        unsigned      *tail = this->sq_field(this->mParams.sq_off.tail);
+        const unsigned mask = *this->sq_field(this->mParams.sq_off.ring_mask);
+        const unsigned at =
+            std::atomic_ref<unsigned>(*tail).load(std::memory_order_relaxed);
+        const unsigned index = at & mask;
+
+        io_uring_sqe &sqe = this->mSqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode    = IORING_OP_READ;
+        sqe.fd        = fd;
+        sqe.addr      = reinterpret_cast<std::uint64_t>(buffer);
+        sqe.len       = length;
+        sqe.off       = offset;
+        sqe.user_data = data;
+
+        this->sq_field(this->mParams.sq_off.array)[index] = index;
+        std::atomic_ref<unsigned>(*tail).store(at + 1,
+                                               std::memory_order_release);
+    }
+
+    // Submits queued reads and waits for at least wait of them to complete.
+    // Returns the number of reads submitted, or -errno
+    int enter(unsigned submit, unsigned wait) {
+        const int res = ::syscall(__NR_io_uring_enter,
+                                  this->mFd,
+                                  submit,
+                                  wait,
+                                  (0 < wait) ? IORING_ENTER_GETEVENTS : 0,
+                                  nullptr,
+                                  0);
+        return (res < 0) ? -errno : res;
+    }
+
+    // Calls handler(data, res) for every completed read
+    void reap(const std::function<void(std::uint64_t, int)> &handler) {
+        unsigned *head = this->cq_field(this->mParams.cq_off.head);
+        unsigned *tail = this->cq_field(this->mParams.cq_off.tail);
+        const unsigned mask = *this->cq_field(this->mParams.cq_off.ring_mask);
+        const auto    *cqes = reinterpret_cast<const io_uring_cqe *>(
+            static_cast<char *>(this->mCqRing) + this->mParams.cq_off.cqes);
+
+        unsigned at =
+            std::atomic_ref<unsigned>(*head).load(std::memory_order_relaxed);
+        const unsigned last =
+            std::atomic_ref<unsigned>(*tail).load(std::memory_order_acquire);
+
+        for (; at != last; at++) {
+            handler(cqes[at & mask].user_data, cqes[at & mask].res);
+        }
+
+        std::atomic_ref<unsigned>(*head).store(at, std::memory_order_release);
+    }
+
+    private:
+    inline unsigned *sq_field(std::uint32_t offset) const {
+        return reinterpret_cast<unsigned *>(static_cast<char *>(this->mSqRing) +
+                                            offset);
+    }
+
+    inline unsigned *cq_field(std::uint32_t offset) const {
+        return reinterpret_cast<unsigned *>(static_cast<char *>(this->mCqRing) +
+                                            offset);
+    }
+};
+#endif
+
+FileLoader::FileLoader(std::size_t threads, unsigned queue_depth)
+    : mThreads((0 == threads)
+                   ? std::max(1u, std::thread::hardware_concurrency())
+                   : threads),
+      mQueueDepth(std::max(1u, queue_depth)), mTryUring(true),
+      mUsedUring(false) {
+}
+
+void FileLoader::load(const std::vector<std::string> &paths,
+                      Callback                        callback) {
+    Queue                    queue;
+    std::vector<std::thread> workers;
+
+    for (std::size_t i = 0; i < this->mThreads; i++) {
+        workers.emplace_back([&queue]() { queue.run(); });
+    }
+
+    this->mUsedUring =
+        this->mTryUring && this->load_uring(paths, callback, queue);
+
+    if (!this->mUsedUring) {
+        for (const auto &path : paths) {
+            queue.push(
+                [&callback, &path]() { callback(path, read_file(path)); });
+        }
+    }
+
+    queue.close();
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+// Opens files and keeps up to mQueueDepth reads in flight on this thread,
+// while the workers run the callbacks of the files read so far. Files that
+// io_uring fails to read are read again by a worker, which reports the error
+bool FileLoader::load_uring(const std::vector<std::string> &paths,
+                            const Callback                 &callback,
+                            Queue                          &queue) const {
+#ifdef LOUVRE_IO_URING
+    // Reads are limited to 1 GiB each, since their length is 32 bits
+    static constexpr std::size_t MAX_READ = 1 << 30;
+
+    class Read {
+        public:
+        int         mFd;
+        std::string mContent;
+        std::size_t mDone;
+        bool        mFinished;
+    };
+
+    Uring ring;
+    if (!ring.open(this->mQueueDepth)) {
+        return false;
+    }
+
+    // On the heap, since the kernel may still write into the buffers of
+    // reads in flight if the ring breaks and cannot be drained
+    auto reads = std::make_unique<std::vector<Read>>(
+        paths.size(), Read{-1, std::string(), 0, false});
+    std::vector<Read> &files = *reads;
+
+    const auto finish = [&](std::size_t index, bool read) {
+        Read &file     = files[index];
+        file.mFinished = true;
+
+        if (0 <= file.mFd) {
+            ::close(file.mFd);
+        }
+
+        const std::string &path = paths[index];
+
+        if (!read) {
+            queue.push(
+                [&callback, &path]() { callback(path, read_file(path)); });
+            return;
+        }
+
+        file.mContent.resize(file.mDone);
+        queue.push([&callback, &path, content = std::move(file.mContent)]() {
+            callback(path, std::move(content));
+        });
+    };
+
+    std::vector<std::size_t> pending;
+    std::size_t              next        = 0;
+    std::size_t              in_flight   = 0;
+    unsigned                 unsubmitted = 0;
+
+    while (next < paths.size() || !pending.empty() || 0 < in_flight ||
+           0 < unsubmitted) {
+        while (in_flight + unsubmitted < ring.entries() &&
+               (!pending.empty() || next < paths.size())) {
+            std::size_t index;
+
+            if (!pending.empty()) {
+                index = pending.back();
+                pending.pop_back();
+            } else {
+                index      = next++;
+                Read &file = files[index];
+                file.mFd   = ::open(paths[index].c_str(), O_RDONLY | O_CLOEXEC);
+
+                struct stat info;
+                if (0 > file.mFd || 0 != ::fstat(file.mFd, &info)) {
+                    finish(index, false);
+                    continue;
+                }
+
+                file.mContent.resize(info.st_size);
+
+                if (0 == info.st_size) {
+                    finish(index, true);
+                    continue;
+                }
+            }
+
+            Read &file = files[index];
+            ring.prepare_read(
+                file.mFd,
+                file.mContent.data() + file.mDone,
+                std::min(file.mContent.length() - file.mDone, MAX_READ),
+                file.mDone,
+                index);
+            unsubmitted++;
+        }
+
+        // Every file queued so far failed to open or was empty
+        if (0 == in_flight + unsubmitted) {
+            continue;
+        }
+
+        // Submits the new reads and waits for at least one read to complete
+        int submitted = ring.enter(unsubmitted, 1);
+        while (-EINTR == submitted || -EAGAIN == submitted ||
+               -EBUSY == submitted) {
+            submitted = ring.enter(unsubmitted, 1);
+        }
+
+        if (submitted < 0) {
+            // The kernel may still write into the buffers of reads in flight,
+            // so their completions are drained and dropped before falling back
+            while (0 < in_flight) {
+                const int res = ring.enter(0, 1);
+                if (res < 0 && -EINTR != res && -EAGAIN != res &&
+                    -EBUSY != res) {
+                    break;
+                }
+
+                ring.reap([&in_flight](std::uint64_t, int) { in_flight--; });
+            }
+
+            // Only reached if the ring cannot even be waited on
+            if (0 < in_flight) {
+                reads.release();
+            }
+
+            for (std::size_t i = 0; i < paths.size(); i++) {
+                if (i < next && files[i].mFinished) {
+                    continue;
+                }
+
+                if (0 == in_flight && 0 <= files[i].mFd) {
+                    ::close(files[i].mFd);
+                }
+
+                queue.push([&callback, &path = paths[i]]() {
+                    callback(path, read_file(path));
+                });
+            }
+
+            return true;
+        }
+
+        unsubmitted -= submitted;
+        in_flight += submitted;
+
+        ring.reap([&](std::uint64_t index, int res) {
+            Read &file = files[index];
+            in_flight--;
+
+            if (-EINTR == res || -EAGAIN == res) {
+                pending.push_back(index);
+                return;
+            }
+
+            if (res < 0) {
+                finish(index, false);
+                return;
+            }
+
+            file.mDone += res;
+
+            // A read of zero bytes means that the file shrank
+            if (0 < res && file.mDone < file.mContent.length()) {
+                pending.push_back(index);
+                return;
+            }
+
+            finish(index, true);
+        });
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace louvre
@@ -0,0 +1,112 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <cstddef>
+#include <functional>
+#include <louvre/api.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <variant>
+
+namespace louvre {
+static inline std::size_t hash_combine(std::size_t seed, std::size_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+std::size_t Node::hash() const {
+    this->materialize();
+
+    std::size_t h =
+        std::hash<std::variant<StandardNodeType, std::string>>{}(this->mType);
+
+    if (this->mText) {
+        h = hash_combine(h, std::hash<std::string>{}(*this->mText));
+    }
+
+    if (this->mTag) {
+        const auto &tag = *this->mTag;
+        h = hash_combine(h, std::hash<std::string>{}(tag->name()));
+
+        for (const auto &arg : tag->arguments()) {
+            h = hash_combine(h, std::hash<std::string>{}(arg));
+        }
+    }
+
+    // Mixing in the number of children tells apart nested and flat layouts
+    // of the same nodes
+    h = hash_combine(h, this->mChildren.size());
+
+    for (const auto &child : this->mChildren) {
+        h = hash_combine(h, child->hash());
+    }
+
+    return h;
+}
+
+std::shared_ptr<Node>
+Node::clone(const std::unordered_map<const Node *, std::shared_ptr<Node>>
+                                        &replacements,
+           const std::function<bool()> &keep) const {
+    if (keep && !keep()) {
+        return nullptr;
+    }
+
+    this->materialize();
+
+    auto copy = std::visit(
+        [](const auto &type) { return std::make_shared<Node>(type); },
+        this->mType);
+
+    copy->mText        = this->mText;
+    copy->mTag         = this->mTag;
+    copy->mSourceStart = this->mSourceStart;
+    copy->mSourceEnd   = this->mSourceEnd;
+
+    for (const auto &child : this->mChildren) {
+        auto it         = replacements.find(child.get());
+        auto child_copy = (replacements.end() == it)
+                              ? child->clone(replacements, keep)
+                              : it->second->clone();
+
+        if (nullptr == child_copy) {
+            return nullptr;
+        }
+
+        copy->add_child(child_copy);
+    }
+
+    return copy;
+}
+
+std::shared_ptr<Node> Node::copy() const {
+    this->materialize();
+
+    auto copy = std::visit(
+        [](const auto &type) { return std::make_shared<Node>(type); },
+        this->mType);
+
+    copy->mText        = this->mText;
+    copy->mTag         = this->mTag;
+    copy->mParent      = this->mParent;
+    copy->mChildren    = this->mChildren;
+    copy->mNum         = this->mNum;
+    copy->mReference   = this->mReference;
+    copy->mSourceStart = this->mSourceStart;
+    copy->mSourceEnd   = this->mSourceEnd;
+    return copy;
+}
+
+} // namespace louvre
@@ -0,0 +1,179 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <louvre/api.hpp>
+#include <louvre/numbering.hpp>
+#include <memory>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace louvre {
+static std::string format_alpha(std::uint32_t value, char base) {
+    std::string buf;
+
+    while (value > 0) {
+        value--;
+        buf.push_back(base + value % 26);
+        value /= 26;
+    }
+
+    std::reverse(buf.begin(), buf.end());
+    return buf;
+}
+
+static std::string format_roman(std::uint32_t value, bool upper) {
+    static const std::pair<std::uint32_t, const char *> numerals[] = {
+        {1000, "m"},
+        {900, "cm"},
+        {500, "d"},
+        {400, "cd"},
+        {100, "c"},
+        {90, "xc"},
+        {50, "l"},
+        {40, "xl"},
+        {10, "x"},
+        {9, "ix"},
+        {5, "v"},
+        {4, "iv"},
+        {1, "i"}};
+
+    std::string buf;
+    for (const auto &[weight, numeral] : numerals) {
+        while (value >= weight) {
+            buf += numeral;
+            value -= weight;
+        }
+    }
+
+    if (upper) {
+        std::transform(buf.begin(), buf.end(), buf.begin(), ::toupper);
+    }
+
+    return buf;
+}
+
+Numbering::Numbering() {
+    this->add_counter(StandardNodeType::Item, StandardNodeType::Numebrs);
+}
+
+void Numbering::compute(std::shared_ptr<Node> root) {
+    this->mValues.clear();
+    this->mRanges.clear();
+
+    std::vector<std::vector<Level>> levels(this->mCounters.size(),
+                                           {Level{0, 0, 0}});
+    this->visit(root, StandardNodeType::Null, levels);
+}
+
+void Numbering::visit(
+    const std::shared_ptr<Node>                       &node,
+    const std::variant<StandardNodeType, std::string> &parent_type,
+    std::vector<std::vector<Level>>                   &levels) {
+    const auto type = node->type();
+
+    for (std::size_t i = 0; i < this->mCounters.size(); i++) {
+        const Counter &counter = this->mCounters[i];
+
+        if (type == counter.mType &&
+            (!counter.mScope || parent_type == *counter.mScope)) {
+            Level &top = levels[i].back();
+            top.mCount++;
+
+            const std::uint32_t offset = this->mValues.size();
+            const std::uint32_t length = top.mPrefixLength + 1;
+            for (std::uint32_t j = 0; j < top.mPrefixLength; j++) {
+                const std::uint32_t value =
+                    this->mValues[top.mPrefixOffset + j];
+                this->mValues.push_back(value);
+            }
+
+            this->mValues.push_back(top.mCount);
+            this->mRanges[node.get()] = std::make_pair(offset, length);
+            levels[i].push_back(Level{0, offset, length});
+        }
+
+        if (counter.mScope && type == *counter.mScope) {
+            const Level top = levels[i].back();
+            levels[i].push_back(Level{0, top.mPrefixOffset, top.mPrefixLength});
+        }
+    }
+
+    for (const auto &child : node->children()) {
+        this->visit(child, type, levels);
+    }
+
+    // Levels are pushed under the same conditions checked above, so popping
+    // them here does not need any bookkeeping
+    for (std::size_t i = 0; i < this->mCounters.size(); i++) {
+        const Counter &counter = this->mCounters[i];
+
+        if (type == counter.mType &&
+            (!counter.mScope || parent_type == *counter.mScope)) {
+            levels[i].pop_back();
+        }
+
+        if (counter.mScope && type == *counter.mScope) {
+            levels[i].pop_back();
+        }
+    }
+}
+
+std::string Numbering::format(const std::shared_ptr<Node>    &node,
+                              const std::vector<NumberStyle> &styles,
+                              const std::string              &separator) const {
+    const auto  values = this->of(node);
+    std::string buf;
+
+    for (std::size_t i = 0; i < values.size(); i++) {
+        if (0 != i) {
+            buf += separator;
+        }
+
+        const NumberStyle style =
+            styles.empty() ? NumberStyle::Decimal
+                           : styles[std::min(i, styles.size() - 1)];
+
+        switch (style) {
+        case NumberStyle::LowerAlpha:
+            buf += format_alpha(values[i], 'a');
+            break;
+
+        case NumberStyle::UpperAlpha:
+            buf += format_alpha(values[i], 'A');
+            break;
+
+        case NumberStyle::LowerRoman:
+            buf += format_roman(values[i], false);
+            break;
+
+        case NumberStyle::UpperRoman:
+            buf += format_roman(values[i], true);
+            break;
+
+        default:
+            buf += std::to_string(values[i]);
+            break;
+        }
+    }
+
+    return buf;
+}
+
+} // namespace louvre
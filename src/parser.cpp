@@ -13,21 +13,59 @@
  *   limitations under the License.
  */
 
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <cstddef>
+#include <cstring>
 #include <cwctype>
+#include <filesystem>
+#include <future>
+#include <limits>
 #include <louvre/api.hpp>
+#include <louvre/include.hpp>
 #include <memory>
 #include <optional>
+#include <stop_token>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
 #include <utility>
 #include <variant>
+#include <vector>
 
 namespace louvre {
-Parser::Parser(std::string source) : mSource(source) {
-    this->mGlobalOffset = 0;
-    this->mLineOffset   = 0;
-    this->mLine         = 0;
-    this->mColumn       = 0;
+// Number of blocks between two checks of the deadline and stop token
+static constexpr std::size_t CANCEL_INTERVAL = 64;
+
+// Number of bytes between two checks within a single block or scan
+static constexpr std::size_t CANCEL_BYTES = 64 * 1024;
+
+// Time between two checks while waiting for a file another parser is parsing
+static constexpr auto INCLUDE_POLL = std::chrono::milliseconds(1);
+
+Parser::Parser(std::string source)
+    : Parser(std::make_shared<const std::string>(std::move(source))) {
+}
+
+Parser::Parser(std::shared_ptr<const std::string> source)
+    : mSource(source), mEnd(source->length()) {
+    this->mGlobalOffset    = 0;
+    this->mLineOffset      = 0;
+    this->mLine            = 0;
+    this->mColumn          = 0;
+    this->mDeferReferences = false;
+    this->mCancellable     = false;
+    this->mNextCancel      = std::numeric_limits<std::size_t>::max();
+    this->mNextCheck       = std::numeric_limits<std::size_t>::max();
+    this->mDepth           = 0;
+    this->mNodeCount       = 0;
+    this->mTagCount        = 0;
+    this->mMemory          = 0;
+    this->mProgressStep    = 0;
+    this->mNextProgress    = std::numeric_limits<std::size_t>::max();
+    this->mLimits.fill(std::numeric_limits<std::size_t>::max());
 
     // #end
     this->add_tag_binding("end", [](std::shared_ptr<Tag> tag) {
@@ -35,53 +73,95 @@ Parser::Parser(std::string source) : mSource(source) {
     });
 
     // #left
-    this->add_tag_binding("left", [](std::shared_ptr<Tag> tag) {
+    this->add_block_tag_binding("left", [](std::shared_ptr<Tag> tag) {
         return std::make_pair(ParserAction::AddChildAndBranch,
                               Node(StandardNodeType::Left));
     });
 
     // #center
-    this->add_tag_binding("center", [](std::shared_ptr<Tag> tag) {
+    this->add_block_tag_binding("center", [](std::shared_ptr<Tag> tag) {
         return std::make_pair(ParserAction::AddChildAndBranch,
                               Node(StandardNodeType::Center));
     });
 
     // #right
-    this->add_tag_binding("right", [](std::shared_ptr<Tag> tag) {
+    this->add_block_tag_binding("right", [](std::shared_ptr<Tag> tag) {
         return std::make_pair(ParserAction::AddChildAndBranch,
                               Node(StandardNodeType::Right));
     });
 
     // #justify
-    this->add_tag_binding("justify", [](std::shared_ptr<Tag> tag) {
+    this->add_block_tag_binding("justify", [](std::shared_ptr<Tag> tag) {
         return std::make_pair(ParserAction::AddChildAndBranch,
                               Node(StandardNodeType::Justify));
     });
 
     // #paragraph
-    this->add_tag_binding("paragraph", [](std::shared_ptr<Tag> tag) {
+    this->add_block_tag_binding("paragraph", [](std::shared_ptr<Tag> tag) {
         return std::make_pair(ParserAction::AddChildAndBranch,
                               Node(StandardNodeType::Paragraph));
     });
 
     // #numbers
-    this->add_tag_binding("numbers", [](std::shared_ptr<Tag> tag) {
+    this->add_block_tag_binding("numbers", [](std::shared_ptr<Tag> tag) {
         return std::make_pair(ParserAction::AddChildAndBranch,
                               Node(StandardNodeType::Numebrs));
     });
 
     // #bullets
-    this->add_tag_binding("bullets", [](std::shared_ptr<Tag> tag) {
+    this->add_block_tag_binding("bullets", [](std::shared_ptr<Tag> tag) {
         return std::make_pair(ParserAction::AddChildAndBranch,
                               Node(StandardNodeType::Bullets));
     });
 
     // #item
-    this->add_tag_binding("item", [](std::shared_ptr<Tag> tag) {
+    this->add_block_tag_binding("item", [](std::shared_ptr<Tag> tag) {
         return std::make_pair(ParserAction::AddChildAndBranch,
                               Node(StandardNodeType::Item));
     });
 
+    // #label(name)
+    this->add_tag_binding("label", [](std::shared_ptr<Tag> tag) {
+        return std::make_pair(ParserAction::AddChild,
+                              Node(StandardNodeType::Label));
+    });
+
+    // #ref(name)
+    this->add_tag_binding("ref", [](std::shared_ptr<Tag> tag) {
+        return std::make_pair(ParserAction::AddChild,
+                              Node(StandardNodeType::Reference));
+    });
+
+    // #define(name, params...)
+    this->add_block_tag_binding("define", [](std::shared_ptr<Tag> tag) {
+        return std::make_pair(ParserAction::Define,
+                              Node(StandardNodeType::Group));
+    });
+
+    // #arg(param)
+    this->add_tag_binding("arg", [](std::shared_ptr<Tag> tag) {
+        return std::make_pair(ParserAction::Argument,
+                              Node(StandardNodeType::Null));
+    });
+
+    // #if(features...)
+    this->add_block_tag_binding("if", [](std::shared_ptr<Tag> tag) {
+        return std::make_pair(ParserAction::Condition,
+                              Node(StandardNodeType::Null));
+    });
+
+    // #var(name)
+    this->add_tag_binding("var", [](std::shared_ptr<Tag> tag) {
+        return std::make_pair(ParserAction::Variable,
+                              Node(StandardNodeType::Null));
+    });
+
+    // #include(path)
+    this->add_tag_binding("include", [](std::shared_ptr<Tag> tag) {
+        return std::make_pair(ParserAction::Include,
+                              Node(StandardNodeType::Null));
+    });
+
     // # (new line)
     this->add_tag_binding("", [](std::shared_ptr<Tag> tag) {
         return std::make_pair(ParserAction::AddChild,
@@ -89,15 +169,316 @@ Parser::Parser(std::string source) : mSource(source) {
     });
 }
 
-std::variant<std::shared_ptr<Node>, SyntaxError, TagError, NodeError>
-Parser::parse() {
+Parser::Parser(std::string source, std::string path)
+    : Parser(std::move(source)) {
+    std::error_code ec;
+    auto            canonical = std::filesystem::weakly_canonical(path, ec);
+
+    // Includes are keyed by canonical path, so that cycles are detected no
+    // matter how each file refers to the others
+    this->mPath = std::make_shared<const std::string>(
+        ec ? path : canonical.string());
+}
+
+std::variant<std::shared_ptr<Node>,
+             SyntaxError,
+             TagError,
+             NodeError,
+             CancelledError,
+             LimitError>
+Parser::parse(std::optional<std::chrono::steady_clock::time_point> deadline,
+              std::stop_token                                      stop) {
     auto root = std::make_shared<Node>();
 
+    if (this->mProgress) {
+        this->mNextProgress = this->mGlobalOffset + this->mProgressStep;
+    }
+
+    this->start(deadline, stop);
+
+    if (this->mSchema) {
+        this->mSchemaParents.push_back(this->mSchema->id_of(*root));
+    }
+
+    const auto workers = this->prefetch_includes();
+    const auto e       = this->parse_into(root);
+
+    // Prefetched files are parsed by now, unless parsing stopped early, in
+    // which case this waits for them rather than leaving threads behind
+    for (const auto worker : workers) {
+        this->mIncludes->join(worker);
+    }
+
+    if (e) {
+        return *e;
+    }
+
+    root->set_source_range(0, this->mEnd);
+
+    if (this->mProgress) {
+        this->mProgress(this->mEnd, this->mEnd, this->mNodeCount);
+    }
+
+    // Included files leave references to the including parser, since they
+    // may point to labels in other files
+    if (this->mDeferReferences) {
+        return root;
+    }
+
+    if (const auto e = this->resolve_references()) {
+        return *e;
+    }
+
+    return root;
+}
+
+std::variant<std::shared_ptr<Node>,
+             SyntaxError,
+             TagError,
+             NodeError,
+             CancelledError,
+             LimitError>
+Parser::parse_lazy(
+    std::optional<std::chrono::steady_clock::time_point> deadline,
+    std::stop_token                                      stop) {
+    this->mLazy            = std::make_shared<Lazy>();
+    this->mLazy->mSource   = this->mSource;
+    this->mDeferReferences = true;
+    this->start(deadline, stop);
+
+    if (const auto e = this->prescan()) {
+        return *e;
+    }
+
+    auto result = this->parse(deadline, stop);
+
+    // Blocks are materialized after parse() returns, with the bindings and
+    // macros known by then. Variables are copied for the same reason
+    Lazy &lazy      = *this->mLazy;
+    lazy.mBindings  = this->mTagBindings;
+    lazy.mBlockTags = this->mBlockTags;
+    lazy.mFeatures  = this->mFeatures;
+    lazy.mIncludes  = this->mIncludes;
+    lazy.mPath      = this->mPath;
+    lazy.mMacros    = this->mMacros;
+    lazy.mLimits    = this->mLimits;
+    lazy.mNodeCount = this->mNodeCount;
+    lazy.mTagCount  = this->mTagCount;
+    lazy.mMemory    = this->mMemory;
+
+    for (const auto &[name, value] : this->mVariables) {
+        lazy.mVariables.emplace(name, value);
+    }
+
+    return result;
+}
+
+// Records the matching #end of every block-opening tag, using the same scan
+// as skip_block(). Blocks left open extend to the end of the source
+const std::optional<CancelledError> Parser::prescan() {
+    const char              *source = this->mSource->data();
+    std::size_t              at     = this->mGlobalOffset;
+    std::vector<std::size_t> open;
+    auto                    &blocks = this->mLazy->mBlocks;
+
+    while (at < this->mEnd) {
+        if (at >= this->mNextCancel) {
+            if (const auto e = this->check_cancelled(at)) {
+                return *e;
+            }
+        }
+
+        // Searched up to the next check at most
+        const std::size_t window = std::min(this->mEnd, this->mNextCancel);
+        const void       *hash   = std::memchr(source + at, '#', window - at);
+
+        if (nullptr == hash) {
+            at = window;
+            continue;
+        }
+
+        const std::size_t tag_start = static_cast<const char *>(hash) - source;
+        at                          = tag_start + 1;
+
+        // ##
+        if (at < this->mEnd && '#' == source[at]) {
+            at++;
+            continue;
+        }
+
+        const std::size_t name_start = at;
+        while (at < this->mEnd && Parser::is_tag_char(source[at])) {
+            at++;
+        }
+
+        const std::string_view name(source + name_start, at - name_start);
+
+        if (at < this->mEnd && '(' == source[at]) {
+            const void *close = std::memchr(source + at, ')', this->mEnd - at);
+            at = (nullptr == close)
+                     ? this->mEnd
+                     : static_cast<const char *>(close) - source + 1;
+        }
+
+        // Blocks are pushed as they open, so they end up sorted
+        if ("end" == name) {
+            if (!open.empty()) {
+                blocks[open.back()].mContentEnd = tag_start;
+                blocks[open.back()].mEnd        = at;
+                open.pop_back();
+            }
+        } else if (this->opens_block(name)) {
+            open.push_back(blocks.size());
+            blocks.push_back(Lazy::Block{tag_start, this->mEnd, this->mEnd});
+        }
+    }
+
+    return std::nullopt;
+}
+
+const Parser::Lazy::Block *Parser::lazy_block(std::size_t start) const {
+    const auto &blocks = this->mLazy->mBlocks;
+    auto        it     = std::lower_bound(
+        blocks.begin(),
+        blocks.end(),
+        start,
+        [](const Lazy::Block &block, std::size_t value) {
+            return block.mStart < value;
+        });
+
+    if (blocks.end() == it || start != it->mStart) {
+        return nullptr;
+    }
+
+    return &*it;
+}
+
+// Skips the content of a block, leaving a loader that parses it on the first
+// call to children(). Nested blocks are deferred in turn. Loaders start at
+// the depth of their block and carry the totals of the whole document, so
+// that limits hold as if the blocks had been parsed by parse()
+void Parser::defer_block(std::shared_ptr<Node>  block,
+                         const Lazy::Block     &range) {
+    const std::size_t content_end = range.mContentEnd;
+    const std::size_t end         = range.mEnd;
+
+    block->set_source_range(block->source_start(), end);
+    block->set_loader([lazy        = this->mLazy,
+                       depth       = this->mDepth + 1,
+                       start       = this->mGlobalOffset,
+                       content_end = content_end,
+                       line        = this->mLine,
+                       column      = this->mColumn,
+                       line_offset = this->mLineOffset](
+                          std::shared_ptr<Node> block) {
+        Parser parser(lazy->mSource);
+        parser.mTagBindings     = lazy->mBindings;
+        parser.mBlockTags       = lazy->mBlockTags;
+        parser.mFeatures        = lazy->mFeatures;
+        parser.mIncludes        = lazy->mIncludes;
+        parser.mPath            = lazy->mPath;
+        parser.mMacros          = lazy->mMacros;
+        parser.mLimits          = lazy->mLimits;
+        parser.mLazy            = lazy;
+        parser.mDeferReferences = true;
+        parser.mGlobalOffset    = start;
+        parser.mEnd             = content_end;
+        parser.mLine            = line;
+        parser.mColumn          = column;
+        parser.mLineOffset      = line_offset;
+        parser.mDepth           = depth;
+        parser.mNodeCount       = lazy->mNodeCount;
+        parser.mTagCount        = lazy->mTagCount;
+        parser.mMemory          = lazy->mMemory;
+        parser.mVariables.insert(lazy->mVariables.begin(),
+                                 lazy->mVariables.end());
+
+        const auto e     = parser.parse_into(block);
+        lazy->mNodeCount = parser.mNodeCount;
+        lazy->mTagCount  = parser.mTagCount;
+        lazy->mMemory    = parser.mMemory;
+
+        if (e) {
+            lazy->mErrors.push_back(*e);
+        }
+    });
+
+    this->skip_to(end);
+}
+
+void Parser::start(
+    std::optional<std::chrono::steady_clock::time_point> deadline,
+    std::stop_token                                      stop) {
+    this->mDeadline    = deadline;
+    this->mStop        = stop;
+    this->mCancellable = deadline.has_value() || stop.stop_possible();
+    this->mNextCancel  = this->mCancellable
+                             ? this->mGlobalOffset + CANCEL_BYTES
+                             : std::numeric_limits<std::size_t>::max();
+    this->mNextCheck   = std::min(this->mNextCancel, this->mNextProgress);
+}
+
+bool Parser::cancelled() const {
+    return this->mStop.stop_requested() ||
+           (this->mDeadline &&
+            std::chrono::steady_clock::now() >= *this->mDeadline);
+}
+
+// Called once a scan reaches mNextCancel, with the offset it reached
+const std::optional<CancelledError>
+Parser::check_cancelled(std::size_t offset) {
+    this->mNextCancel = offset + CANCEL_BYTES;
+    this->mNextCheck  = std::min(this->mNextCancel, this->mNextProgress);
+
+    if (this->cancelled()) {
+        return CancelledError(this->location());
+    }
+
+    return std::nullopt;
+}
+
+// Called once a block reaches mNextCheck. Scans only check for cancellation,
+// since the parser does not move until they are done
+const std::optional<CancelledError> Parser::check_block() {
+    if (this->mGlobalOffset >= this->mNextProgress) {
+        this->report_progress();
+    }
+
+    if (this->mGlobalOffset >= this->mNextCancel) {
+        return this->check_cancelled(this->mGlobalOffset);
+    }
+
+    return std::nullopt;
+}
+
+void Parser::report_progress() {
+    this->mProgress(this->mGlobalOffset, this->mEnd, this->mNodeCount);
+    this->mNextProgress = this->mGlobalOffset + this->mProgressStep;
+    this->mNextCheck    = std::min(this->mNextCancel, this->mNextProgress);
+}
+
+// Parses from the current offset up to mEnd, adding nodes under base
+const std::optional<ParseResult>
+Parser::parse_into(std::shared_ptr<Node> base) {
+    auto        root   = base;
+    std::size_t blocks = 0;
+
     while (this->can_advance()) {
+        if (this->mCancellable && 0 == ++blocks % CANCEL_INTERVAL &&
+            this->cancelled()) {
+            return CancelledError(this->location());
+        }
+
+        if (this->mGlobalOffset >= this->mNextProgress) {
+            this->report_progress();
+        }
+
         const std::optional<
             std::variant<std::pair<ParserAction, std::shared_ptr<Node>>,
                          SyntaxError,
-                         TagError>>
+                         TagError,
+                         CancelledError,
+                         LimitError>>
             block_opt = this->collect_block();
 
         if (!block_opt) {
@@ -114,25 +495,181 @@ Parser::parse() {
             return std::get<TagError>(block_res);
         }
 
+        if (std::holds_alternative<CancelledError>(block_res)) {
+            return std::get<CancelledError>(block_res);
+        }
+
+        if (std::holds_alternative<LimitError>(block_res)) {
+            return std::get<LimitError>(block_res);
+        }
+
         const auto [action, node] =
             std::get<std::pair<ParserAction, std::shared_ptr<Node>>>(block_res);
 
+        // Directives such as #include and #end leave no node behind
+        if (ParserAction::AddChild == action ||
+            ParserAction::AddChildAndBranch == action ||
+            ParserAction::Define == action ||
+            ParserAction::Argument == action) {
+            if (const auto e = this->count_node(0)) {
+                return *e;
+            }
+        }
+
+        // Macro bodies are only templates: their nodes are checked and
+        // indexed when they are expanded
+        const bool defining = this->mDefinition.has_value();
+
+        // In lazy mode, blocks are added without their content
+        const Lazy::Block *deferred =
+            (ParserAction::AddChildAndBranch == action && this->mLazy &&
+             !defining)
+                ? this->lazy_block(node->source_start())
+                : nullptr;
+
+        if (!defining) {
+            if (const auto e = this->index_label(node)) {
+                return *e;
+            }
+        }
+
+        if (this->mSchema && !defining &&
+            (ParserAction::AddChild == action ||
+             ParserAction::AddChildAndBranch == action)) {
+            const std::uint16_t id = this->mSchema->id_of(*node);
+
+            if (const auto e = this->mSchema->check(
+                    *node,
+                    id,
+                    this->mSchemaParents.back(),
+                    this->mSchemaParents.size())) {
+                return NodeError(*e, node);
+            }
+
+            if (ParserAction::AddChildAndBranch == action &&
+                nullptr == deferred) {
+                this->mSchemaParents.push_back(id);
+            }
+        }
+
         switch (action) {
         case ParserAction::AddChild:
             root->add_child(node);
+
+            if (!defining && !this->mOpenHeadings.empty()) {
+                this->record_heading_title(root, node);
+            }
             break;
 
         case ParserAction::AddChildAndBranch:
             root->add_child(node);
+
+            // Deferred blocks are as deep as if they were parsed now
+            if (this->mDepth + 1 > this->limit(Limit::Depth)) {
+                return LimitError(
+                    "Nesting too deep", Limit::Depth, this->location());
+            }
+
+            if (nullptr != deferred) {
+                this->defer_block(node, *deferred);
+
+                // The closing #end is skipped along with the block
+                if (deferred->mContentEnd < deferred->mEnd &&
+                    ++this->mTagCount > this->limit(Limit::Tags)) {
+                    return LimitError(
+                        "Too many tags", Limit::Tags, this->location());
+                }
+                break;
+            }
+
+            if (!defining && !this->mHeadingTypes.empty()) {
+                this->record_heading(node);
+            }
+
+            this->mDepth++;
             root = node;
             break;
 
         case ParserAction::End:
-            if (!root->parent()) {
+            // An #if that held leaves no node behind, so its #end does not
+            // walk back
+            if (!this->mConditions.empty() &&
+                root == this->mConditions.back()) {
+                this->mConditions.pop_back();
+                break;
+            }
+
+            if (root == base) {
                 return NodeError("Unexpected branch return at root leve", node);
             }
 
+            if (defining && root == this->mDefinition->second.mBody) {
+                root->set_source_range(root->source_start(),
+                                       this->mGlobalOffset);
+                root = root->parent().value();
+                this->mDepth--;
+                this->register_macro();
+                break;
+            }
+
+            if (!this->mOpenHeadings.empty() &&
+                root == this->mOpenHeadings.back().first) {
+                this->mOpenHeadings.pop_back();
+            }
+
+            if (this->mSchema && !defining) {
+                this->mSchemaParents.pop_back();
+            }
+
+            root->set_source_range(root->source_start(), this->mGlobalOffset);
             root = root->parent().value();
+            this->mDepth--;
+            break;
+
+        case ParserAction::Include:
+            if (const auto e = this->include(root, node)) {
+                return *e;
+            }
+            break;
+
+        case ParserAction::Define:
+            if (const auto e = this->define(root, node)) {
+                return *e;
+            }
+
+            if (++this->mDepth > this->limit(Limit::Depth)) {
+                return LimitError(
+                    "Nesting too deep", Limit::Depth, this->location());
+            }
+
+            root = node;
+            break;
+
+        case ParserAction::Argument:
+            if (const auto e = this->add_slot(root, node)) {
+                return *e;
+            }
+            break;
+
+        case ParserAction::Condition: {
+            const auto holds = this->test_condition(node->tag().value());
+
+            if (std::holds_alternative<TagError>(holds)) {
+                return std::get<TagError>(holds);
+            }
+
+            if (std::get<bool>(holds)) {
+                this->mConditions.push_back(root);
+            } else if (const auto e = this->skip_block()) {
+                return *e;
+            }
+            break;
+        }
+
+        case ParserAction::Expand:
+            if (const auto e = this->expand(root, node)) {
+                return *e;
+            }
             break;
 
         default:
@@ -140,7 +677,643 @@ Parser::parse() {
         }
     }
 
-    return root;
+    if (this->mDefinition) {
+        return TagError("Unterminated macro definition",
+                        this->mDefinition->second.mBody->tag().value());
+    }
+
+    // Blocks left open at EOF extend to the end of the source
+    while (root != base) {
+        root->set_source_range(root->source_start(), this->mEnd);
+        root = root->parent().value();
+        this->mDepth--;
+    }
+
+    return std::nullopt;
+}
+
+const std::optional<TagError>
+Parser::index_label(std::shared_ptr<Node> node) {
+    const bool is_label     = node->is(StandardNodeType::Label);
+    const bool is_reference = node->is(StandardNodeType::Reference);
+
+    if (!is_label && !is_reference) {
+        return std::nullopt;
+    }
+
+    const auto tag = node->tag().value();
+    if (1 != tag->arguments().size()) {
+        return TagError("Expected exactly one argument", tag);
+    }
+
+    if (is_reference) {
+        // References may point forward, so they are resolved in a single
+        // pass once the whole document has been parsed
+        this->mReferences.push_back(node);
+        return std::nullopt;
+    }
+
+    if (!this->mLabels.insert(tag->arguments().front(), node)) {
+        return TagError("Duplicate label", tag);
+    }
+
+    return std::nullopt;
+}
+
+const std::optional<TagError> Parser::resolve_references() {
+    for (const auto &reference : this->mReferences) {
+        const auto tag    = reference->tag().value();
+        const auto target = this->mLabels.find(tag->arguments().front());
+
+        if (!target) {
+            return TagError("Unresolved reference", tag);
+        }
+
+        reference->set_reference(*target);
+    }
+
+    return std::nullopt;
+}
+
+void Parser::record_heading(std::shared_ptr<Node> node) {
+    const auto type = node->type();
+
+    for (const auto &heading_type : this->mHeadingTypes) {
+        if (type == heading_type) {
+            const std::size_t entry =
+                this->mToc.add_entry(this->mOpenHeadings.size(), node);
+            this->mOpenHeadings.push_back(std::make_pair(node, entry));
+            return;
+        }
+    }
+}
+
+void Parser::record_heading_title(std::shared_ptr<Node> parent,
+                                  std::shared_ptr<Node> node) {
+    const auto [heading, entry] = this->mOpenHeadings.back();
+
+    if (parent == heading && !this->mToc.has_title(entry) && node->text()) {
+        this->mToc.set_title(entry, *node->text());
+    }
+}
+
+const std::string Parser::resolve_include(const std::string &path) const {
+    std::filesystem::path target(path);
+
+    if (target.is_relative() && nullptr != this->mPath) {
+        target = std::filesystem::path(*this->mPath).parent_path() / target;
+    }
+
+    std::error_code ec;
+    auto            canonical = std::filesystem::weakly_canonical(target, ec);
+    return ec ? target.lexically_normal().string() : canonical.string();
+}
+
+// Everything besides its source that the tree of an included file depends
+// on. Bindings are told apart by name and by the type of their callable,
+// since functions cannot be compared
+const std::string Parser::include_config() const {
+    std::string config;
+    const auto  append = [&config](std::string_view field) {
+        config += std::to_string(field.length());
+        config.push_back(':');
+        config += field;
+    };
+
+    std::vector<std::string> bindings;
+    for (const auto &[name, binding] : this->mTagBindings) {
+        if (!this->mMacros.contains(name)) {
+            bindings.push_back(name + ' ' + binding.target_type().name());
+        }
+    }
+
+    std::vector<std::string> blocks(this->mBlockTags.begin(),
+                                    this->mBlockTags.end());
+    std::vector<std::string> features(this->mFeatures.begin(),
+                                      this->mFeatures.end());
+    std::vector<std::pair<std::string_view, std::string_view>> variables(
+        this->mVariables.begin(), this->mVariables.end());
+
+    std::sort(bindings.begin(), bindings.end());
+    std::sort(blocks.begin(), blocks.end());
+    std::sort(features.begin(), features.end());
+    std::sort(variables.begin(), variables.end());
+
+    for (const auto *fields : {&bindings, &blocks, &features}) {
+        config += std::to_string(fields->size()) + ';';
+        for (const auto &field : *fields) {
+            append(field);
+        }
+    }
+
+    config += std::to_string(variables.size()) + ';';
+    for (const auto &[name, value] : variables) {
+        append(name);
+        append(value);
+    }
+
+    for (const auto limit : this->mLimits) {
+        config += std::to_string(limit) + ';';
+    }
+
+    return config;
+}
+
+const IncludeLoader
+Parser::include_loader(const std::string &path) const {
+    // Macros are local to the file that defines them, and the cached tree of
+    // a file must not depend on who includes it
+    auto bindings = this->mTagBindings;
+    for (const auto &[name, macro] : this->mMacros) {
+        bindings.erase(name);
+    }
+
+    return [bindings = std::move(bindings),
+            blocks   = this->mBlockTags,
+            includes = this->mIncludes,
+            features = this->mFeatures,
+            limits   = this->mLimits,
+            values   = std::unordered_map<std::string, std::string>(
+                this->mVariables.begin(), this->mVariables.end()),
+            path](std::string source) {
+        Parser parser(std::move(source), path);
+        parser.mTagBindings     = bindings;
+        parser.mBlockTags       = blocks;
+        parser.mFeatures        = features;
+        parser.mVariables.insert(values.begin(), values.end());
+        parser.mIncludes        = includes;
+        parser.mLimits          = limits;
+        parser.mDeferReferences = true;
+        return parser.parse();
+    };
+}
+
+// Returns the threads started, which parse() joins before returning
+std::vector<std::size_t> Parser::prefetch_includes() {
+    static const std::string_view directive = "#include(";
+    std::vector<std::size_t>      workers;
+    std::string                   config;
+
+    for (std::size_t at = this->mSource->find(directive, this->mGlobalOffset);
+         std::string::npos != at && at < this->mEnd;
+         at = this->mSource->find(directive, at + 1)) {
+        // An odd number of # before the tag means that it was escaped
+        std::size_t hashes = 0;
+        while (hashes < at && '#' == (*this->mSource)[at - hashes - 1]) {
+            hashes++;
+        }
+
+        const std::size_t first = at + directive.length();
+        const std::size_t close = this->mSource->find_first_of(",)", first);
+
+        if (1 == hashes % 2 || std::string::npos == close ||
+            close >= this->mEnd || ')' != (*this->mSource)[close]) {
+            continue;
+        }
+
+        if (nullptr == this->mIncludes) {
+            this->mIncludes = std::make_shared<IncludeCache>();
+        }
+
+        if (config.empty()) {
+            config = this->include_config();
+        }
+
+        std::string path = this->mSource->substr(first, close - first);
+        path             = this->resolve_include(Parser::trim(path));
+        if (const auto worker = this->mIncludes->prefetch(
+                path, config, this->include_loader(path))) {
+            workers.push_back(*worker);
+        }
+    }
+
+    return workers;
+}
+
+const std::optional<ParseResult>
+Parser::include(std::shared_ptr<Node> parent, std::shared_ptr<Node> directive) {
+    const auto tag = directive->tag().value();
+
+    if (1 != tag->arguments().size()) {
+        return TagError("Expected exactly one argument", tag);
+    }
+
+    if (nullptr == this->mIncludes) {
+        this->mIncludes = std::make_shared<IncludeCache>();
+    }
+
+    const std::string path   = this->resolve_include(tag->arguments().front());
+    const std::string waiter = (nullptr != this->mPath) ? *this->mPath : "";
+    this->mIncluded.push_back(path);
+
+    if (!this->mIncludes->begin_wait(waiter, path)) {
+        return TagError("Include cycle", tag);
+    }
+
+    const auto pending = this->mIncludes->get(
+        waiter, path, this->include_config(), this->include_loader(path));
+
+    // Another parser may still be parsing the file
+    while (this->mCancellable &&
+           std::future_status::ready != pending.wait_for(INCLUDE_POLL)) {
+        if (this->cancelled()) {
+            this->mIncludes->end_wait(waiter, path);
+            return CancelledError(this->location());
+        }
+    }
+
+    const auto result = pending.get();
+    this->mIncludes->end_wait(waiter, path);
+
+    if (!result) {
+        return TagError("Cannot read included file", tag);
+    }
+
+    if (!std::holds_alternative<std::shared_ptr<Node>>(*result)) {
+        return *result;
+    }
+
+    // The cached tree is shared with other parsers, so it is copied before
+    // being spliced in place of the directive
+    const auto included = std::get<std::shared_ptr<Node>>(*result);
+
+    for (const auto &child : included->children()) {
+        const auto copy = child->clone();
+        parent->add_child(copy);
+
+        if (this->mDefinition) {
+            continue;
+        }
+
+        if (const auto e = this->adopt(parent,
+                                       copy,
+                                       directive->source_start(),
+                                       directive->source_end())) {
+            return *e;
+        }
+    }
+
+    return std::nullopt;
+}
+
+// #if(a, !b) holds if feature a is set and feature b is not
+const std::variant<bool, TagError>
+Parser::test_condition(std::shared_ptr<Tag> tag) const {
+    const auto &arguments = tag->arguments();
+
+    if (arguments.empty()) {
+        return TagError("Expected at least one feature", tag);
+    }
+
+    for (const auto &argument : arguments) {
+        const bool  negated = argument.starts_with('!');
+        std::string feature = negated ? argument.substr(1) : argument;
+
+        if (negated == this->mFeatures.contains(Parser::trim(feature))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Whether the tag needs a matching #end. Decided by name, since calling a
+// binding for a tag that is never collected could fail or have side effects
+bool Parser::opens_block(std::string_view name) const {
+    return this->mBlockTags.contains(name);
+}
+
+const std::variant<std::string_view, TagError>
+Parser::resolve_variable(std::shared_ptr<Tag> tag) const {
+    if (1 != tag->arguments().size()) {
+        return TagError("Expected exactly one argument", tag);
+    }
+
+    auto it = this->mVariables.find(tag->arguments().front());
+
+    if (this->mVariables.end() == it) {
+        return TagError("Undefined variable", tag);
+    }
+
+    return it->second;
+}
+
+// Moves past the #end that matches an #if whose condition does not hold.
+// Only tag names are looked at, so that nothing is allocated for the
+// skipped text. Unknown tags are not reported
+const std::optional<CancelledError> Parser::skip_block() {
+    const char       *source = this->mSource->data();
+    const std::size_t length = this->mEnd;
+    std::size_t       at     = this->mGlobalOffset;
+    std::size_t       depth  = 1;
+
+    while (at < length) {
+        if (at >= this->mNextCancel) {
+            if (const auto e = this->check_cancelled(at)) {
+                return *e;
+            }
+        }
+
+        // Searched up to the next check at most
+        const std::size_t window = std::min(length, this->mNextCancel);
+        const void       *hash   = std::memchr(source + at, '#', window - at);
+
+        if (nullptr == hash) {
+            at = window;
+            continue;
+        }
+
+        at = static_cast<const char *>(hash) - source + 1;
+
+        // ##
+        if (at < length && '#' == source[at]) {
+            at++;
+            continue;
+        }
+
+        const std::size_t name_start = at;
+        while (at < length && Parser::is_tag_char(source[at])) {
+            at++;
+        }
+
+        const std::string_view name(source + name_start, at - name_start);
+
+        if (at < length && '(' == source[at]) {
+            const void *close = std::memchr(source + at, ')', length - at);
+            at = (nullptr == close)
+                     ? length
+                     : static_cast<const char *>(close) - source + 1;
+        }
+
+        if ("end" == name) {
+            if (0 == --depth) {
+                break;
+            }
+        } else if (this->opens_block(name)) {
+            depth++;
+        }
+    }
+
+    this->skip_to(at);
+    return std::nullopt;
+}
+
+// Same as advancing byte by byte, without looking at every byte
+void Parser::skip_to(std::size_t offset) {
+    const std::string_view skipped = std::string_view(*this->mSource).substr(
+        this->mGlobalOffset, offset - this->mGlobalOffset);
+    const std::size_t last_line = skipped.find_last_of("\r\n");
+
+    // collect_block() starts a new line on both \r and \n
+    if (std::string_view::npos != last_line) {
+        this->mLine += std::count(skipped.begin(), skipped.end(), '\n') +
+                       std::count(skipped.begin(), skipped.end(), '\r');
+        this->mColumn     = 0;
+        this->mLineOffset = 0;
+    }
+
+    const std::string_view tail = (std::string_view::npos == last_line)
+                                      ? skipped
+                                      : skipped.substr(last_line + 1);
+
+    this->mLineOffset += tail.length();
+    this->mGlobalOffset = offset;
+
+    // UTF-8 continuation bytes (10xxxxxx) do not start a column
+    for (const char c : tail) {
+        if (0b10000000 != (c & 0b11000000)) {
+            this->mColumn++;
+        }
+    }
+}
+
+const std::optional<TagError> Parser::define(std::shared_ptr<Node> parent,
+                                             std::shared_ptr<Node> directive) {
+    const auto  tag       = directive->tag().value();
+    const auto &arguments = tag->arguments();
+
+    if (this->mDefinition) {
+        return TagError("Nested macro definition", tag);
+    }
+
+    if (arguments.empty()) {
+        return TagError("Expected a macro name", tag);
+    }
+
+    const std::string &name = arguments.front();
+    for (const char c : name) {
+        if (!Parser::is_tag_char(c)) {
+            return TagError("Invalid macro name", tag);
+        }
+    }
+
+    if (this->mTagBindings.contains(name)) {
+        return TagError("Tag already defined", tag);
+    }
+
+    // The body hangs off the current node without being one of its
+    // children, so that #end walks back to it
+    Macro macro;
+    macro.mParameters.assign(arguments.begin() + 1, arguments.end());
+    macro.mBody = directive;
+    directive->set_parent(parent);
+    this->mDefinition = std::make_pair(name, std::move(macro));
+    return std::nullopt;
+}
+
+// Adds up the nodes below node and the length of their text
+static void measure(const Node &node, std::size_t &nodes, std::size_t &text) {
+    for (const auto &child : node.children()) {
+        const auto &child_text = child->text();
+        nodes++;
+        text += child_text ? child_text->length() : 0;
+        measure(*child, nodes, text);
+    }
+}
+
+void Parser::register_macro() {
+    auto [name, macro] = std::move(*this->mDefinition);
+    this->mDefinition.reset();
+    measure(*macro.mBody, macro.mNodes, macro.mTextLength);
+
+    this->add_tag_binding(name, [](std::shared_ptr<Tag> tag) {
+        return std::make_pair(ParserAction::Expand,
+                              Node(StandardNodeType::Null));
+    });
+
+    this->mMacros.emplace(std::move(name), std::move(macro));
+}
+
+const std::optional<TagError> Parser::add_slot(std::shared_ptr<Node> parent,
+                                               std::shared_ptr<Node> slot) {
+    const auto tag = slot->tag().value();
+
+    if (!this->mDefinition) {
+        return TagError("Argument outside of macro definition", tag);
+    }
+
+    if (1 != tag->arguments().size()) {
+        return TagError("Expected exactly one argument", tag);
+    }
+
+    Macro     &macro = this->mDefinition->second;
+    const auto param = std::find(macro.mParameters.begin(),
+                                 macro.mParameters.end(),
+                                 tag->arguments().front());
+
+    if (macro.mParameters.end() == param) {
+        return TagError("Unknown macro parameter", tag);
+    }
+
+    parent->add_child(slot);
+    macro.mSlots.push_back(
+        std::make_pair(slot.get(), param - macro.mParameters.begin()));
+    return std::nullopt;
+}
+
+const std::optional<ParseResult>
+Parser::expand(std::shared_ptr<Node> parent, std::shared_ptr<Node> invocation) {
+    const auto tag = invocation->tag().value();
+    auto       it  = this->mMacros.find(tag->name());
+
+    if (this->mMacros.end() == it) {
+        return TagError("Unknown tag", tag);
+    }
+
+    Macro      &macro     = it->second;
+    const auto &arguments = tag->arguments();
+
+    if (macro.mParameters.size() != arguments.size()) {
+        return TagError("Expected " + std::to_string(macro.mParameters.size()) +
+                            " arguments",
+                        tag);
+    }
+
+    std::unordered_map<const Node *, std::shared_ptr<Node>> replacements;
+    std::size_t text_length = macro.mTextLength;
+
+    for (const auto &[slot, param] : macro.mSlots) {
+        replacements.emplace(
+            slot, std::make_shared<Node>(Node::text(arguments[param])));
+        text_length += arguments[param].length();
+    }
+
+    // Counted as a whole before anything is cloned, inside definitions too,
+    // so that nested macros cannot build more than the limits allow
+    if (const auto e = this->count_nodes(macro.mNodes, text_length)) {
+        return *e;
+    }
+
+    // Large expansions are checked for cancellation as they are cloned
+    std::size_t           cloned = 0;
+    std::function<bool()> keep;
+
+    if (this->mCancellable) {
+        keep = [this, &cloned]() {
+            return 0 != ++cloned % CANCEL_INTERVAL || !this->cancelled();
+        };
+    }
+
+    // Cloned straight into the parent. Slots that are direct children of
+    // the body take their fresh text node as is
+    for (const auto &child : macro.mBody->children()) {
+        const auto it   = replacements.find(child.get());
+        const auto copy = (replacements.end() == it)
+                              ? child->clone(replacements, keep)
+                              : it->second;
+
+        if (nullptr == copy) {
+            return CancelledError(this->location());
+        }
+
+        parent->add_child(copy);
+
+        if (this->mDefinition) {
+            continue;
+        }
+
+        if (const auto e = this->adopt(parent,
+                                       copy,
+                                       invocation->source_start(),
+                                       invocation->source_end(),
+                                       true)) {
+            return *e;
+        }
+    }
+
+    return std::nullopt;
+}
+
+// Does for an included file or an expanded macro what parse() does for each
+// node it adds. The spliced nodes take the source range of the tag that
+// produced them, since their own ranges refer to another file or to the
+// macro definition. Nodes are not counted again if they already are
+const std::optional<ParseResult>
+Parser::adopt(std::shared_ptr<Node> parent,
+              std::shared_ptr<Node> node,
+              std::size_t           start,
+              std::size_t           end,
+              bool                  counted) {
+    node->set_source_range(start, end);
+
+    const auto &text = node->text();
+    if (!counted) {
+        if (const auto e = this->count_node(text ? text->length() : 0)) {
+            return *e;
+        }
+    }
+
+    if (const auto e = this->index_label(node)) {
+        return *e;
+    }
+
+    if (this->mSchema) {
+        const std::uint16_t id = this->mSchema->id_of(*node);
+
+        if (const auto e = this->mSchema->check(*node,
+                                                id,
+                                                this->mSchemaParents.back(),
+                                                this->mSchemaParents.size())) {
+            return NodeError(*e, node);
+        }
+
+        this->mSchemaParents.push_back(id);
+    }
+
+    if (!this->mOpenHeadings.empty()) {
+        this->record_heading_title(parent, node);
+    }
+
+    if (!this->mHeadingTypes.empty()) {
+        this->record_heading(node);
+    }
+
+    const auto children = node->children();
+
+    if (!children.empty() && ++this->mDepth > this->limit(Limit::Depth)) {
+        return LimitError("Nesting too deep", Limit::Depth, this->location());
+    }
+
+    for (const auto &child : children) {
+        if (const auto e = this->adopt(node, child, start, end, counted)) {
+            return *e;
+        }
+    }
+
+    if (!children.empty()) {
+        this->mDepth--;
+    }
+
+    if (!this->mOpenHeadings.empty() &&
+        node == this->mOpenHeadings.back().first) {
+        this->mOpenHeadings.pop_back();
+    }
+
+    if (this->mSchema) {
+        this->mSchemaParents.pop_back();
+    }
+
+    return std::nullopt;
 }
 
 // TODO: properly support UTF8 whitespace chracters
@@ -159,17 +1332,51 @@ inline std::string Parser::trim(std::string &s) {
     return s;
 }
 
+inline bool Parser::is_blank(const std::string &s) {
+    return s.empty() || " " == s;
+}
+
 inline bool Parser::is_tag_char(char c) {
     return std::isalnum(c) || '_' == c;
 }
 
 inline const SourceLocation Parser::location() const {
-    return SourceLocation(
-        this->mLine, this->mColumn, this->mGlobalOffset, this->mLineOffset);
+    return SourceLocation(this->mLine,
+                          this->mColumn,
+                          this->mGlobalOffset,
+                          this->mLineOffset,
+                          this->mPath);
+}
+
+inline std::size_t Parser::limit(Limit limit) const {
+    return this->mLimits[static_cast<std::size_t>(limit)];
+}
+
+// Counts a node about to be added to the tree. The text of nodes built by
+// collect_block() is counted as it is collected
+const std::optional<LimitError> Parser::count_node(std::size_t text_length) {
+    return this->count_nodes(1, text_length);
+}
+
+const std::optional<LimitError>
+Parser::count_nodes(std::size_t count, std::size_t text_length) {
+    this->mMemory += count * sizeof(Node) + text_length;
+    this->mNodeCount += count;
+
+    if (this->mNodeCount > this->limit(Limit::Nodes)) {
+        return LimitError("Too many nodes", Limit::Nodes, this->location());
+    }
+
+    if (this->mMemory > this->limit(Limit::Memory)) {
+        return LimitError(
+            "Memory limit exceeded", Limit::Memory, this->location());
+    }
+
+    return std::nullopt;
 }
 
 inline bool Parser::can_advance(std::size_t amount) const {
-    return this->mGlobalOffset + amount < this->mSource.length();
+    return this->mGlobalOffset + amount < this->mEnd;
 }
 
 inline void Parser::advance(std::size_t amount) {
@@ -181,7 +1388,8 @@ inline void Parser::advance(std::size_t amount) {
         this->mGlobalOffset += 1;
         this->mLineOffset += 1;
 
-        if (0 == masked || masked >= 0b1100) {
+        // Count every byte but UTF-8 continuation bytes (10xxxxxx)
+        if (masked < 0b1000 || masked >= 0b1100) {
             this->mColumn += 1;
         }
     }
@@ -189,7 +1397,7 @@ inline void Parser::advance(std::size_t amount) {
 
 inline const std::optional<char> Parser::peek(std::size_t ahead) const {
     if (this->can_advance(ahead)) {
-        return this->mSource[this->mGlobalOffset + ahead];
+        return (*this->mSource)[this->mGlobalOffset + ahead];
     }
 
     return std::nullopt;
@@ -230,6 +1438,20 @@ Parser::consume_if(const std::string &allowed) {
     return this->consume();
 }
 
+// #var is a reserved name, recognized before the tag is collected. Its
+// binding only keeps #define(var) from taking the name
+bool Parser::is_variable_tag() const {
+    std::size_t end = this->mGlobalOffset + 1;
+    while (end < this->mEnd &&
+           Parser::is_tag_char((*this->mSource)[end])) {
+        end++;
+    }
+
+    const std::string_view name = std::string_view(*this->mSource).substr(
+        this->mGlobalOffset + 1, end - this->mGlobalOffset - 1);
+    return "var" == name;
+}
+
 std::string Parser::collect_sequence() {
     std::string buf;
 
@@ -240,21 +1462,54 @@ std::string Parser::collect_sequence() {
     return buf;
 }
 
-const std::variant<std::shared_ptr<Tag>, SyntaxError> Parser::collect_tag() {
+// Arguments run up to the next comma or closing parenthesis, so that they may
+// hold paths and symbols. Surrounding whitespace is dropped
+std::string Parser::collect_argument() {
+    std::string buf;
+
+    while (this->can_advance() && ',' != this->quick_peek() &&
+           ')' != this->quick_peek()) {
+        if ('\n' == this->quick_peek()) {
+            buf.push_back(' ');
+            this->advance();
+            this->advance_line();
+            continue;
+        }
+
+        buf.push_back(this->consume());
+    }
+
+    return Parser::trim(buf);
+}
+
+const std::variant<std::shared_ptr<Tag>, SyntaxError, LimitError>
+Parser::collect_tag() {
     this->advance();
     SourceLocation location = this->location();
     std::string    tag_name = this->collect_sequence();
-    auto           tag = std::make_shared<Tag>(std::move(tag_name), location);
+    this->mMemory += sizeof(Tag) + tag_name.length();
+    auto tag = std::make_shared<Tag>(std::move(tag_name), location);
+
+    if (++this->mTagCount > this->limit(Limit::Tags)) {
+        return LimitError("Too many tags", Limit::Tags, location);
+    }
 
     if (std::holds_alternative<SyntaxError>(this->consume_if("("))) {
         return tag;
     }
 
+    std::size_t arguments = 0;
+
     while (true) {
-        this->skip_whitespace();
-        std::string arg = this->collect_sequence();
+        std::string arg = this->collect_argument();
 
         if (!arg.empty()) {
+            if (++arguments > this->limit(Limit::Arguments)) {
+                return LimitError(
+                    "Too many arguments", Limit::Arguments, this->location());
+            }
+
+            this->mMemory += sizeof(std::string) + arg.length();
             tag->add_argument(arg);
         }
 
@@ -286,11 +1541,22 @@ Parser::tag_to_node(std::shared_ptr<Tag> tag) {
 
 const std::optional<std::variant<std::pair<ParserAction, std::shared_ptr<Node>>,
                                  SyntaxError,
-                                 TagError>>
+                                 TagError,
+                                 CancelledError,
+                                 LimitError>>
 Parser::collect_block() {
-    std::string buf;
+    const std::size_t max_text = this->limit(Limit::TextLength);
+    std::string       buf;
+    std::size_t text_start = this->mGlobalOffset;
+    std::size_t text_end   = this->mGlobalOffset;
 
     while (this->can_advance()) {
+        if (this->mGlobalOffset >= this->mNextCheck) {
+            if (const auto e = this->check_block()) {
+                return *e;
+            }
+        }
+
         const char cur = this->quick_peek();
 
         if ('\t' == cur) {
@@ -309,8 +1575,18 @@ Parser::collect_block() {
         const char next = this->quick_peek(1);
 
         if (cur == next && '#' == cur) {
+            if (Parser::is_blank(buf)) {
+                text_start = this->mGlobalOffset;
+            }
+
             buf.push_back(cur);
             this->advance(2);
+            text_end = this->mGlobalOffset;
+
+            if (buf.length() > max_text) {
+                return LimitError(
+                    "Text run too long", Limit::TextLength, this->location());
+            }
             continue;
         }
 
@@ -325,25 +1601,75 @@ Parser::collect_block() {
         }
 
         if ('#' != cur) {
+            if (Parser::is_blank(buf)) {
+                text_start = this->mGlobalOffset;
+            }
+
             buf.push_back(cur);
             this->advance();
+            text_end = this->mGlobalOffset;
+
+            if (buf.length() > max_text) {
+                return LimitError(
+                    "Text run too long", Limit::TextLength, this->location());
+            }
+            continue;
+        }
+
+        // #var(name) is part of the text, so that its value merges with the
+        // text around it
+        if (this->is_variable_tag()) {
+            if (Parser::is_blank(buf)) {
+                text_start = this->mGlobalOffset;
+            }
+
+            const auto tag_res = this->collect_tag();
+
+            if (std::holds_alternative<SyntaxError>(tag_res)) {
+                return std::get<SyntaxError>(tag_res);
+            }
+
+            if (std::holds_alternative<LimitError>(tag_res)) {
+                return std::get<LimitError>(tag_res);
+            }
+
+            const auto value = this->resolve_variable(
+                std::get<std::shared_ptr<Tag>>(tag_res));
+
+            if (std::holds_alternative<TagError>(value)) {
+                return std::get<TagError>(value);
+            }
+
+            buf.append(std::get<std::string_view>(value));
+            text_end = this->mGlobalOffset;
+
+            if (buf.length() > max_text) {
+                return LimitError(
+                    "Text run too long", Limit::TextLength, this->location());
+            }
             continue;
         }
 
         // #<tag>
         if (!Parser::trim(buf).empty()) {
-            return std::make_pair(
-                ParserAction::AddChild,
-                std::make_shared<Node>(std::move(Node::text(buf))));
+            this->mMemory += buf.length();
+            auto node = std::make_shared<Node>(std::move(Node::text(buf)));
+            node->set_source_range(text_start, text_end);
+            return std::make_pair(ParserAction::AddChild, node);
         }
 
-        const std::variant<std::shared_ptr<Tag>, SyntaxError> tag_res =
-            this->collect_tag();
+        const std::size_t tag_start = this->mGlobalOffset;
+        const std::variant<std::shared_ptr<Tag>, SyntaxError, LimitError>
+            tag_res = this->collect_tag();
 
         if (std::holds_alternative<SyntaxError>(tag_res)) {
             return std::get<SyntaxError>(tag_res);
         }
 
+        if (std::holds_alternative<LimitError>(tag_res)) {
+            return std::get<LimitError>(tag_res);
+        }
+
         const auto tag = std::get<std::shared_ptr<Tag>>(tag_res);
         const std::variant<std::pair<ParserAction, std::shared_ptr<Node>>,
                            TagError>
@@ -353,14 +1679,17 @@ Parser::collect_block() {
             return std::get<TagError>(node_res);
         }
 
-        return std::get<std::pair<ParserAction, std::shared_ptr<Node>>>(
-            node_res);
+        const auto block =
+            std::get<std::pair<ParserAction, std::shared_ptr<Node>>>(node_res);
+        block.second->set_source_range(tag_start, this->mGlobalOffset);
+        return block;
     }
 
     if (!Parser::trim(buf).empty()) {
-        return std::make_pair(
-            ParserAction::AddChild,
-            std::make_shared<Node>(std::move(Node::text(buf))));
+        this->mMemory += buf.length();
+        auto node = std::make_shared<Node>(std::move(Node::text(buf)));
+        node->set_source_range(text_start, text_end);
+        return std::make_pair(ParserAction::AddChild, node);
     }
 
     return std::nullopt;
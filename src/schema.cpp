@@ -0,0 +1,119 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <louvre/api.hpp>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace louvre {
+void Schema::assign_id(
+    const std::variant<StandardNodeType, std::string> &type) {
+    if (auto standard = std::get_if<StandardNodeType>(&type)) {
+        const std::size_t index = static_cast<std::size_t>(*standard);
+
+        if (index >= this->mStandardIds.size()) {
+            this->mStandardIds.resize(index + 1, 0);
+        }
+
+        if (0 == this->mStandardIds[index]) {
+            this->mStandardIds[index] = this->mTypeCount++;
+        }
+
+        return;
+    }
+
+    const auto &custom = std::get<std::string>(type);
+    if (!this->mCustomIds.contains(custom)) {
+        this->mCustomIds[custom] = this->mTypeCount++;
+    }
+}
+
+std::uint16_t
+Schema::type_id(const std::variant<StandardNodeType, std::string> &type) const {
+    if (auto standard = std::get_if<StandardNodeType>(&type)) {
+        const std::size_t index = static_cast<std::size_t>(*standard);
+        return (index < this->mStandardIds.size()) ? this->mStandardIds[index]
+                                                   : 0;
+    }
+
+    if (this->mCustomIds.empty()) {
+        return 0;
+    }
+
+    auto it = this->mCustomIds.find(std::get<std::string>(type));
+    return (this->mCustomIds.end() != it) ? it->second : 0;
+}
+
+void Schema::compile() {
+    this->mStandardIds.clear();
+    this->mCustomIds.clear();
+    this->mTypeCount = 1;
+
+    for (const auto &[parent, child] : this->mRules) {
+        this->assign_id(parent);
+        this->assign_id(child);
+    }
+
+    // Row and column 0 stand for all types without rules. A child type with
+    // rules is only allowed under the parents listed for it, every other
+    // combination is allowed
+    const std::size_t n = this->mTypeCount;
+    this->mTable.assign(n * n, 1);
+
+    for (const auto &[parent, child] : this->mRules) {
+        const std::uint16_t c = this->type_id(child);
+
+        for (std::size_t p = 0; p < n; p++) {
+            this->mTable[p * n + c] = 0;
+        }
+    }
+
+    for (const auto &[parent, child] : this->mRules) {
+        this->mTable[this->type_id(parent) * n + this->type_id(child)] = 1;
+    }
+}
+
+const std::optional<std::string> Schema::check(const Node   &node,
+                                               std::uint16_t id,
+                                               std::uint16_t parent,
+                                               std::size_t   depth) const {
+    if (depth > this->mMaxDepth) {
+        return "Maximum nesting depth exceeded";
+    }
+
+    if (0 == this->mTable[parent * this->mTypeCount + id]) {
+        return "Node not allowed in this parent";
+    }
+
+    if (const auto &tag = node.tag(); tag && !this->mArgumentCounts.empty()) {
+        auto it = this->mArgumentCounts.find((*tag)->name());
+
+        if (this->mArgumentCounts.end() != it) {
+            const std::size_t count = (*tag)->arguments().size();
+
+            if (count < it->second.first || count > it->second.second) {
+                return "Unexpected number of arguments";
+            }
+        }
+    }
+
+    return std::nullopt;
+}
+
+} // namespace louvre
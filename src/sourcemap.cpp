@@ -0,0 +1,190 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <louvre/sourcemap.hpp>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace louvre {
+// Mappings between two checkpoints
+static constexpr std::size_t CHECKPOINT_INTERVAL = 32;
+
+void SourceMap::push_varint(std::uint64_t value) {
+    while (value >= 0x80) {
+        this->mBytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+
+    this->mBytes.push_back(static_cast<std::uint8_t>(value));
+}
+
+void SourceMap::add(std::size_t output_offset, std::size_t source_offset) {
+    if (0 == this->mCount % CHECKPOINT_INTERVAL) {
+        this->mCheckpoints.push_back(Checkpoint{this->mBytes.size(),
+                                                this->mLastOutput,
+                                                this->mLastSource,
+                                                output_offset});
+    }
+
+    // Output deltas are never negative. Source deltas are zigzag encoded
+    // since emitters may reorder content
+    const std::int64_t source_delta =
+        static_cast<std::int64_t>(source_offset) -
+        static_cast<std::int64_t>(this->mLastSource);
+
+    this->push_varint(output_offset - this->mLastOutput);
+    this->push_varint((static_cast<std::uint64_t>(source_delta) << 1) ^
+                      static_cast<std::uint64_t>(source_delta >> 63));
+
+    this->mLastOutput = output_offset;
+    this->mLastSource = source_offset;
+    this->mCount++;
+    this->mBySource.clear();
+}
+
+void SourceMap::clear() {
+    this->mBytes.clear();
+    this->mCheckpoints.clear();
+    this->mBySource.clear();
+    this->mCount      = 0;
+    this->mLastOutput = 0;
+    this->mLastSource = 0;
+}
+
+void SourceMap::decode(std::size_t &byte,
+                       std::size_t &output,
+                       std::size_t &source) const {
+    std::uint64_t values[2] = {0, 0};
+
+    for (auto &value : values) {
+        int shift = 0;
+
+        while (true) {
+            const std::uint8_t b = this->mBytes[byte++];
+            value |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+
+            if (0 == (b & 0x80)) {
+                break;
+            }
+
+            shift += 7;
+        }
+    }
+
+    const std::int64_t source_delta =
+        static_cast<std::int64_t>(values[1] >> 1) ^
+        -static_cast<std::int64_t>(values[1] & 1);
+
+    output += values[0];
+    source += source_delta;
+}
+
+const std::optional<std::size_t>
+SourceMap::to_source(std::size_t output_offset) const {
+    // Output offsets never decrease, so the answer is in the run of the last
+    // checkpoint whose first mapping is not past the offset
+    const auto it = std::upper_bound(
+        this->mCheckpoints.begin(),
+        this->mCheckpoints.end(),
+        output_offset,
+        [](std::size_t value, const Checkpoint &checkpoint) {
+            return value < checkpoint.mOutput;
+        });
+
+    if (this->mCheckpoints.begin() == it) {
+        return std::nullopt;
+    }
+
+    const std::size_t run = (it - this->mCheckpoints.begin()) - 1;
+    const std::size_t end =
+        std::min(this->mCount, (run + 1) * CHECKPOINT_INTERVAL);
+
+    std::size_t                byte   = this->mCheckpoints[run].mByte;
+    std::size_t                output = this->mCheckpoints[run].mPreviousOutput;
+    std::size_t                source = this->mCheckpoints[run].mPreviousSource;
+    std::optional<std::size_t> found;
+
+    for (std::size_t i = run * CHECKPOINT_INTERVAL; i < end; i++) {
+        this->decode(byte, output, source);
+
+        if (output > output_offset) {
+            break;
+        }
+
+        found = source;
+    }
+
+    return found;
+}
+
+void SourceMap::finalize() {
+    this->mBySource.clear();
+    this->mBySource.reserve(this->mCount);
+    this->for_each([this](std::size_t output, std::size_t source) {
+        this->mBySource.push_back(std::make_pair(source, output));
+    });
+
+    const auto by_source = [](const auto &a, const auto &b) {
+        return a.first < b.first;
+    };
+
+    // Emitters that follow the source need no sorting. Otherwise the sort is
+    // stable, so that ties keep output order and the last mapping for a
+    // source offset is the last one emitted
+    if (!std::is_sorted(
+            this->mBySource.begin(), this->mBySource.end(), by_source)) {
+        std::stable_sort(
+            this->mBySource.begin(), this->mBySource.end(), by_source);
+    }
+}
+
+const std::optional<std::size_t>
+SourceMap::to_output(std::size_t source_offset) const {
+    // Not finalized: nothing may be cached here since const readers can run
+    // concurrently, so scan every mapping instead
+    if (this->mBySource.size() != this->mCount) {
+        std::optional<std::size_t> found;
+        std::size_t                best = 0;
+
+        this->for_each([&](std::size_t output, std::size_t source) {
+            if (source <= source_offset && (!found || source >= best)) {
+                best  = source;
+                found = output;
+            }
+        });
+
+        return found;
+    }
+
+    const auto it = std::upper_bound(
+        this->mBySource.begin(),
+        this->mBySource.end(),
+        source_offset,
+        [](std::size_t value, const std::pair<std::size_t, std::size_t> &p) {
+            return value < p.first;
+        });
+
+    if (this->mBySource.begin() == it) {
+        return std::nullopt;
+    }
+
+    return (it - 1)->second;
+}
+
+} // namespace louvre
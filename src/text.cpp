@@ -0,0 +1,252 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <cstddef>
+#include <louvre/api.hpp>
+#include <louvre/linebreak.hpp>
+#include <louvre/text.hpp>
+#include <louvre/width.hpp>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace louvre {
+// Columns added by each #paragraph
+static constexpr std::size_t PARAGRAPH_INDENT = 4;
+
+std::string TextEmitter::emit(std::shared_ptr<Node> root) {
+    this->mOutput.clear();
+    this->mRun.clear();
+    this->mMarker.clear();
+    this->mBullet = "-";
+    this->mIndent = 0;
+    this->mAlign  = StandardNodeType::Left;
+    this->mNumbering.compute(root);
+
+    if (nullptr != this->mSourceMap) {
+        this->mSourceMap->clear();
+    }
+
+    this->visit_children(root);
+    this->flush();
+
+    if (nullptr != this->mSourceMap) {
+        this->mSourceMap->finalize();
+    }
+
+    return std::move(this->mOutput);
+}
+
+void TextEmitter::visit(const std::shared_ptr<Node> &node) {
+    if (const auto &text = node->text()) {
+        if (!this->mRun.empty()) {
+            this->mRun.push_back(' ');
+        } else {
+            this->mRunSource = node->source_start();
+        }
+
+        this->mRun += *text;
+        return;
+    }
+
+    const auto *type = std::get_if<StandardNodeType>(&node->type());
+
+    if (nullptr == type) {
+        this->visit_children(node);
+        return;
+    }
+
+    switch (*type) {
+    case StandardNodeType::LineBreak:
+        // A line break with nothing before it is an empty line
+        if (this->mRun.empty() && this->mMarker.empty()) {
+            this->mOutput.push_back('\n');
+        }
+
+        this->flush();
+        break;
+
+    case StandardNodeType::Label:
+        break;
+
+    case StandardNodeType::Reference:
+        if (!this->mRun.empty()) {
+            this->mRun.push_back(' ');
+        } else {
+            this->mRunSource = node->source_start();
+        }
+
+        this->mRun += node->tag().value()->arguments().front();
+        break;
+
+    case StandardNodeType::Left:
+    case StandardNodeType::Center:
+    case StandardNodeType::Right:
+    case StandardNodeType::Justify: {
+        this->open(node);
+        const StandardNodeType outer = this->mAlign;
+        this->mAlign                 = *type;
+        this->visit_children(node);
+        this->flush();
+        this->mAlign = outer;
+        break;
+    }
+
+    case StandardNodeType::Paragraph:
+        this->open(node);
+        this->mIndent += PARAGRAPH_INDENT;
+        this->visit_children(node);
+        this->flush();
+        this->mIndent -= PARAGRAPH_INDENT;
+        break;
+
+    case StandardNodeType::Item: {
+        this->open(node);
+
+        std::string marker = this->mNumbering.format(node);
+
+        if (!marker.empty()) {
+            marker += ".";
+        } else {
+            marker = this->mBullet;
+        }
+
+        // Continuation lines are aligned with the first word after the
+        // marker
+        marker += " ";
+        const std::size_t hang = display_width(marker);
+        this->mMarker          = std::move(marker);
+        this->mIndent += hang;
+        this->visit_children(node);
+        this->flush();
+        this->mIndent -= hang;
+        break;
+    }
+
+    case StandardNodeType::Bullets:
+    case StandardNodeType::Numebrs: {
+        const auto  tag   = node->tag();
+        std::string outer = std::move(this->mBullet);
+        this->mBullet     = (tag && !(*tag)->arguments().empty())
+                                ? (*tag)->arguments().front()
+                                : "-";
+        this->open(node);
+        this->visit_children(node);
+        this->flush();
+        this->mBullet = std::move(outer);
+        break;
+    }
+
+    default:
+        this->open(node);
+        this->visit_children(node);
+        this->flush();
+        break;
+    }
+}
+
+void TextEmitter::visit_children(const std::shared_ptr<Node> &node) {
+    for (const auto &child : node->children()) {
+        this->visit(child);
+    }
+}
+
+// Lays out the pending text run before a block, which starts where the
+// output ends
+void TextEmitter::open(const std::shared_ptr<Node> &node) {
+    this->flush();
+    this->mark(node->source_start());
+}
+
+void TextEmitter::mark(std::size_t source) {
+    if (nullptr != this->mSourceMap) {
+        this->mSourceMap->add(this->mOutput.size(), source);
+    }
+}
+
+// Lays out the pending text run. The marker of an item is written at the
+// start of its first line, or on a line of its own if the item has no text
+void TextEmitter::flush() {
+    if (this->mRun.empty() && this->mMarker.empty()) {
+        return;
+    }
+
+    const std::size_t available =
+        (this->mWidth > this->mIndent) ? this->mWidth - this->mIndent : 1;
+    std::vector<std::string> lines;
+
+    if (StandardNodeType::Justify == this->mAlign) {
+        lines = this->mBreaker.justify(this->mRun, available, this->mMode);
+    } else {
+        const auto words = LineBreaker::split_words(this->mRun);
+
+        for (const auto &line :
+             this->mBreaker.break_words(words, available, this->mMode)) {
+            std::string buf;
+
+            for (std::size_t i = line.first(); i < line.last(); i++) {
+                if (i != line.first()) {
+                    buf.push_back(' ');
+                }
+
+                buf += words[i];
+            }
+
+            lines.push_back(std::move(buf));
+        }
+    }
+
+    if (lines.empty()) {
+        lines.emplace_back();
+    }
+
+    for (std::size_t i = 0; i < lines.size(); i++) {
+        std::size_t indent = this->mIndent;
+
+        if (0 == i && !this->mMarker.empty()) {
+            indent -= display_width(this->mMarker);
+        }
+
+        this->mOutput.append(indent, ' ');
+
+        if (0 == i) {
+            this->mOutput += this->mMarker;
+        }
+
+        const std::size_t width = display_width(lines[i]);
+        const std::size_t slack = (available > width) ? available - width : 0;
+
+        if (StandardNodeType::Center == this->mAlign) {
+            this->mOutput.append(slack / 2, ' ');
+        } else if (StandardNodeType::Right == this->mAlign) {
+            this->mOutput.append(slack, ' ');
+        }
+
+        if (0 == i && !this->mRun.empty()) {
+            this->mark(this->mRunSource);
+        }
+
+        this->mOutput += lines[i];
+        this->mOutput.push_back('\n');
+    }
+
+    this->mRun.clear();
+    this->mMarker.clear();
+}
+
+} // namespace louvre
@@ -0,0 +1,134 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <louvre/width.hpp>
+#include <string_view>
+
+#include "width_table.hpp"
+
+namespace louvre {
+static inline std::size_t table_width(char32_t codepoint) {
+    if (codepoint >= 0x110000) {
+        return 1;
+    }
+
+    const std::uint8_t block  = WIDTH_STAGE1[codepoint >> 8];
+    const std::uint8_t packed = WIDTH_STAGE2[block][(codepoint & 0xFF) >> 2];
+    return (packed >> ((codepoint & 3) * 2)) & 3;
+}
+
+static inline std::size_t ascii_width(unsigned char c) {
+    return (c >= 0x20 && c != 0x7F) ? 1 : 0;
+}
+
+// Decodes one UTF-8 sequence starting at text[i] and advances i past it.
+// Returns false if the sequence is invalid, in which case i is advanced by
+// a single byte
+static inline bool
+decode(std::string_view text, std::size_t &i, char32_t &codepoint) {
+    const unsigned char lead = text[i];
+    std::size_t         length;
+
+    if (0xC0 == (lead & 0xE0)) {
+        length    = 2;
+        codepoint = lead & 0x1F;
+    } else if (0xE0 == (lead & 0xF0)) {
+        length    = 3;
+        codepoint = lead & 0x0F;
+    } else if (0xF0 == (lead & 0xF8)) {
+        length    = 4;
+        codepoint = lead & 0x07;
+    } else {
+        i++;
+        return false;
+    }
+
+    if (i + length > text.length()) {
+        i++;
+        return false;
+    }
+
+    for (std::size_t j = 1; j < length; j++) {
+        const unsigned char c = text[i + j];
+
+        if (0x80 != (c & 0xC0)) {
+            i++;
+            return false;
+        }
+
+        codepoint = (codepoint << 6) | (c & 0x3F);
+    }
+
+    i += length;
+    return true;
+}
+
+std::size_t codepoint_width(char32_t codepoint) {
+    if (codepoint < 0x80) {
+        return ascii_width(codepoint);
+    }
+
+    return table_width(codepoint);
+}
+
+std::size_t display_width(std::string_view text) {
+    constexpr std::uint64_t ones = 0x0101010101010101ULL;
+    constexpr std::uint64_t high = 0x8080808080808080ULL;
+
+    std::size_t width = 0;
+    std::size_t i     = 0;
+
+    while (i < text.length()) {
+        // SWAR fast path: 8 bytes of printable ASCII are 8 columns. A chunk
+        // is rejected if any byte has the high bit set, is below 0x20 or is
+        // DEL (0x7F)
+        if (i + 8 <= text.length()) {
+            std::uint64_t chunk;
+            std::memcpy(&chunk, text.data() + i, sizeof(chunk));
+
+            const std::uint64_t below_space = (chunk - 0x20 * ones) & ~chunk;
+            const std::uint64_t del         = chunk ^ (0x7F * ones);
+            const std::uint64_t is_del      = (del - ones) & ~del;
+
+            if (0 == ((chunk | below_space | is_del) & high)) {
+                width += 8;
+                i += 8;
+                continue;
+            }
+        }
+
+        const unsigned char c = text[i];
+
+        if (c < 0x80) {
+            width += ascii_width(c);
+            i++;
+            continue;
+        }
+
+        char32_t codepoint;
+        if (decode(text, i, codepoint)) {
+            width += table_width(codepoint);
+        } else {
+            width += 1;
+        }
+    }
+
+    return width;
+}
+
+} // namespace louvre
@@ -0,0 +1,101 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <louvre/louvre.h>
+#include <stdio.h>
+#include <string.h>
+
+#define mstr(x) #x
+
+#define massert(expr)                                          \
+    if (!(expr)) {                                             \
+        fprintf(stderr, "Assertion failed " mstr(expr) "\n"); \
+        return -1;                                             \
+    }
+
+static const char SOURCE[] = "#paragraph\n"
+                             "See #ref(second) and #ref(first)\n"
+                             "#label(first)\n"
+                             "#end\n"
+                             "#paragraph\n"
+                             "#label(second)\n"
+                             "See #ref(first)\n"
+                             "#end\n";
+
+static int equals(louvre_string string, const char *expected) {
+    return string.length == strlen(expected) &&
+           0 == memcmp(string.data, expected, string.length);
+}
+
+int main(void) {
+    louvre_document *doc = louvre_parse(SOURCE, sizeof(SOURCE) - 1, NULL);
+    massert(NULL != doc);
+    massert(LOUVRE_OK == louvre_document_status(doc));
+    massert(0 == louvre_document_error(doc).length);
+    massert(LOUVRE_TYPE_ROOT == louvre_node_type(doc, 0));
+    massert(louvre_document_size(doc) == louvre_node_subtree_end(doc, 0));
+
+    size_t             count    = 0;
+    const louvre_node *children = louvre_node_children(doc, 0, &count);
+    massert(2 == count);
+    massert(children[0] == louvre_node_child(doc, 0, 0));
+    massert(LOUVRE_NO_NODE == louvre_node_child(doc, 0, 2));
+
+    const louvre_node first = children[0];
+    massert(LOUVRE_TYPE_PARAGRAPH == louvre_node_type(doc, first));
+    massert(0 == louvre_node_parent(doc, first));
+    massert(1 == louvre_node_depth(doc, first));
+    massert(equals(louvre_node_tag(doc, first), "paragraph"));
+    massert(0 == louvre_node_argument_count(doc, first));
+
+    const louvre_node see = louvre_node_child(doc, first, 0);
+    massert(LOUVRE_TYPE_TEXT == louvre_node_type(doc, see));
+    massert(equals(louvre_node_text(doc, see), "See"));
+    massert(0 == louvre_node_number(doc, see));
+
+    // Strings point into the document, so asking twice returns the same
+    // bytes
+    massert(louvre_node_text(doc, see).data ==
+            louvre_node_text(doc, see).data);
+
+    const louvre_node ref = louvre_node_child(doc, first, 1);
+    massert(LOUVRE_TYPE_REFERENCE == louvre_node_type(doc, ref));
+    massert(1 == louvre_node_argument_count(doc, ref));
+    massert(equals(louvre_node_argument(doc, ref, 0), "second"));
+    massert(0 == louvre_node_argument(doc, ref, 1).length);
+
+    const louvre_node target = louvre_node_reference(doc, ref);
+    massert(LOUVRE_TYPE_LABEL == louvre_node_type(doc, target));
+    massert(children[1] == louvre_node_parent(doc, target));
+    massert(LOUVRE_NO_NODE == louvre_node_reference(doc, see));
+
+    size_t start = 0, end = 0;
+    louvre_node_source_range(doc, see, &start, &end);
+    massert(0 == memcmp(SOURCE + start, "See", end - start));
+    massert(see == louvre_node_at(doc, start));
+    louvre_document_free(doc);
+
+    doc = louvre_parse("#paragraph\n#unknown\n#end\n", 25, "doc.lv");
+    massert(LOUVRE_TAG_ERROR == louvre_document_status(doc));
+    massert(0 == louvre_document_size(doc));
+    massert(0 != louvre_document_error(doc).length);
+
+    size_t line = 0, column = 0;
+    massert(louvre_document_error_location(doc, &line, &column));
+    massert(1 == line);
+    louvre_document_free(doc);
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <louvre/api.hpp>
+#include <memory>
+#include <stop_token>
+#include <string>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+int main(void) {
+    std::string source;
+    for (int i = 0; i < 10000; i++) {
+        source += "#paragraph Some text #end\n";
+    }
+
+    // A deadline in the past stops the parser at the first check
+    auto late     = louvre::Parser(source);
+    auto late_res = late.parse(std::chrono::steady_clock::now());
+    massert(std::holds_alternative<louvre::CancelledError>(late_res));
+
+    auto offset =
+        std::get<louvre::CancelledError>(late_res).location().global_offset();
+    massert(0 < offset && offset < source.length());
+
+    std::stop_source stop;
+    stop.request_stop();
+    auto stopped = louvre::Parser(source);
+    massert(std::holds_alternative<louvre::CancelledError>(
+        stopped.parse(std::nullopt, stop.get_token())));
+
+    auto lazy = louvre::Parser(source);
+    massert(std::holds_alternative<louvre::CancelledError>(
+        lazy.parse_lazy(std::nullopt, stop.get_token())));
+
+    // Long runs of text and skipped blocks are checked as well, not only
+    // the boundaries between blocks
+    const std::string run(1 << 20, 'a');
+    const std::string inputs[3] = {run, "#if(x) " + run, "#left " + run};
+
+    for (const auto &input : inputs) {
+        auto long_run = louvre::Parser(input);
+        auto long_res = long_run.parse(std::chrono::steady_clock::now());
+        massert(std::holds_alternative<louvre::CancelledError>(long_res));
+    }
+
+    auto scanned = louvre::Parser("#left " + run + " #end");
+    massert(std::holds_alternative<louvre::CancelledError>(
+        scanned.parse_lazy(std::chrono::steady_clock::now())));
+
+    // So are macros that expand into millions of nodes
+    std::string macros = "#define(a0) x #end ";
+    for (int i = 1; i <= 7; i++) {
+        macros += "#define(a" + std::to_string(i) + ") ";
+        for (int j = 0; j < 10; j++) {
+            macros += "#a" + std::to_string(i - 1) + " ";
+        }
+        macros += "#end ";
+    }
+
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
+    auto expanded     = louvre::Parser(macros + "#a7");
+    auto expanded_res = expanded.parse(deadline);
+    massert(std::holds_alternative<louvre::CancelledError>(expanded_res));
+    massert(std::chrono::steady_clock::now() <
+            deadline + std::chrono::seconds(2));
+
+    // Neither stops a parse that has time left
+    auto early = louvre::Parser(source);
+    auto early_res =
+        early.parse(std::chrono::steady_clock::now() + std::chrono::hours(1),
+                    std::stop_source().get_token());
+    massert(std::holds_alternative<std::shared_ptr<louvre::Node>>(early_res));
+    massert(10000 == std::get<std::shared_ptr<louvre::Node>>(early_res)
+                         ->children()
+                         .size());
+
+    return 0;
+}
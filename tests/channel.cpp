@@ -0,0 +1,95 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "protocol.hpp"
+
+#include <cstddef>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+// Sends raw bytes to a channel, then closes the connection
+static std::optional<louvre::cli::Request>
+receive(const std::string &bytes, std::size_t max_field = 1024) {
+    int fds[2];
+    if (0 != ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds)) {
+        return std::nullopt;
+    }
+
+    louvre::cli::Channel channel(fds[0], max_field);
+    const ssize_t        written = ::write(fds[1], bytes.data(), bytes.size());
+    ::close(fds[1]);
+
+    if (written != static_cast<ssize_t>(bytes.size())) {
+        return std::nullopt;
+    }
+
+    return channel.receive_request();
+}
+
+int main(void) {
+    const auto raw = receive("convert text 40 5 2\n/a.lvHi");
+    massert(raw && "text" == raw->mFormat && 40 == raw->mWidth);
+    massert("/a.lv" == raw->mPath && raw->mSource && "Hi" == *raw->mSource);
+
+    const auto by_path = receive("convert text 80 5 -\n/a.lv");
+    massert(by_path && "/a.lv" == by_path->mPath && !by_path->mSource);
+
+    // Malformed headers, sizes that are too large and truncated fields are
+    // all rejected without allocating what the peer asked for
+    massert(!receive("hello\n"));
+    massert(!receive("convert text 80\n"));
+    massert(!receive("convert text 80 5 12x\n/a.lv12x"));
+    massert(!receive("convert text 80 999999999999999999 -\n"));
+    massert(!receive("convert text 80 5 999999999999999999\n/a.lv"));
+    massert(!receive("convert text 80 2000 -\n" + std::string(2000, 'a')));
+    massert(!receive("convert text 80 5 -\n/a"));
+    massert(!receive(std::string(8192, 'a')));
+    massert(receive("convert text 80 2000 -\n" + std::string(2000, 'a'), 2000));
+
+    // Messages follow each other on the same connection
+    int fds[2];
+    massert(0 == ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    louvre::cli::Channel client(fds[0]);
+    louvre::cli::Channel server(fds[1]);
+
+    massert(client.send(louvre::cli::Request{"text", 72, "/b.lv", "Body"}));
+    massert(client.send(louvre::cli::Request{"text", 80, "/c.lv", {}}));
+
+    const auto first  = server.receive_request();
+    const auto second = server.receive_request();
+    massert(first && "/b.lv" == first->mPath && "Body" == *first->mSource);
+    massert(second && "/c.lv" == second->mPath && !second->mSource);
+
+    massert(server.send(louvre::cli::Response{false, 4, "Output"}));
+    massert(server.send(louvre::cli::Response{true, 0, "Failed"}));
+
+    const auto ok    = client.receive_response();
+    const auto error = client.receive_response();
+    massert(ok && !ok->mFailed && 4 == ok->mBytesIn && "Output" == ok->mBody);
+    massert(error && error->mFailed && "Failed" == error->mBody);
+
+    return 0;
+}
@@ -0,0 +1,54 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <cstddef>
+#include <iostream>
+#include <louvre/api.hpp>
+#include <memory>
+#include <string>
+#include <variant>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+// Line and column of the name of the unknown tag in source, or (-1, -1)
+std::pair<long, long> location_of(const std::string &source) {
+    auto parser    = louvre::Parser(source);
+    auto parse_res = parser.parse();
+
+    if (auto e = std::get_if<louvre::TagError>(&parse_res)) {
+        return std::make_pair(e->tag()->location().line(),
+                              e->tag()->location().column());
+    }
+
+    return std::make_pair(-1, -1);
+}
+
+int main(void) {
+    massert(std::make_pair(0L, 7L) == location_of("Hello #unknown"));
+    massert(std::make_pair(1L, 3L) == location_of("Hello\n  #unknown"));
+
+    // Multi-byte UTF-8 sequences take a single column
+    massert(std::make_pair(0L, 7L) == location_of("H\xc3\xa9llo #unknown"));
+    massert(std::make_pair(0L, 4L) ==
+            location_of("\xe2\x82\xac\xf0\x9f\x98\x80 #unknown"));
+
+    return 0;
+}
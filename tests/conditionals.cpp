@@ -0,0 +1,90 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <iostream>
+#include <louvre/api.hpp>
+#include <memory>
+#include <string>
+#include <utility>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+const std::string SOURCE = "Always\n"
+                           "#if(pro)\n"
+                           "#paragraph Pro #end\n"
+                           "#end\n"
+                           "#if(lite)\n"
+                           "#paragraph\n"
+                           "  #if(pro) nested #end ##end #label(lite)\n"
+                           "  #bogus(#end, x) #aside stray #end\n"
+                           "#end\n"
+                           "Still hidden\n"
+                           "#end\n"
+                           "#if(!lite, pro) Both #end\n"
+                           "#if(lite, pro) Neither #end\n"
+                           "#center Last #end\n";
+
+int main(void) {
+    // #aside only appears in skipped blocks, so its binding is never called
+    int  calls  = 0;
+    auto parser = louvre::Parser(SOURCE);
+    parser.add_block_tag_binding(
+        "aside", [&calls](std::shared_ptr<louvre::Tag> tag) {
+            calls++;
+            return std::make_pair(louvre::ParserAction::AddChildAndBranch,
+                                  louvre::Node("aside"));
+        });
+    parser.set_features({"pro"});
+
+    auto parse_res = parser.parse();
+    massert(std::holds_alternative<std::shared_ptr<louvre::Node>>(parse_res));
+
+    auto root = std::get<std::shared_ptr<louvre::Node>>(parse_res);
+    massert(4 == root->children().size());
+    massert("Always" == root->children().at(0)->text().value());
+    massert(root->children().at(1)->is(louvre::StandardNodeType::Paragraph));
+    massert("Pro" ==
+            root->children().at(1)->children().at(0)->text().value());
+    massert("Both" == root->children().at(2)->text().value());
+    massert(root->children().at(3)->is(louvre::StandardNodeType::Center));
+    massert(0 == parser.labels().size());
+    massert(0 == calls);
+
+    // Skipped lines still count
+    auto last = root->children().at(3)->tag().value()->location();
+    massert(13 == last.line() && 1 == last.column());
+
+    // Errors after a skipped block point to the right place
+    auto bad     = louvre::Parser("#if(x)\n é #end é #unknown");
+    auto bad_res = bad.parse();
+    massert(std::holds_alternative<louvre::TagError>(bad_res));
+    auto location = std::get<louvre::TagError>(bad_res).tag()->location();
+    massert(1 == location.line() && 11 == location.column());
+    massert(20 == location.global_offset() && 13 == location.line_offset());
+
+    auto empty     = louvre::Parser("#if #end");
+    auto empty_res = empty.parse();
+    massert(std::holds_alternative<louvre::TagError>(empty_res));
+    massert("Expected at least one feature" ==
+            std::get<louvre::TagError>(empty_res).message());
+
+    return 0;
+}
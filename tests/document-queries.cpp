@@ -0,0 +1,93 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <iostream>
+#include <louvre/api.hpp>
+#include <louvre/document.hpp>
+#include <memory>
+#include <string>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+const std::string SOURCE = "#article\n"
+                           "#numbers\n"
+                           "#item One #end\n"
+                           "#item Two\n"
+                           "#bullets #item Nested #end #end\n"
+                           "#end\n"
+                           "#end\n"
+                           "#end\n"
+                           "#article\n"
+                           "#numbers #item Three #end #end\n"
+                           "#end\n";
+
+int main(void) {
+    auto parser = louvre::Parser(SOURCE);
+    parser.add_tag_binding("article", [](std::shared_ptr<louvre::Tag> tag) {
+        return std::make_pair(louvre::ParserAction::AddChildAndBranch,
+                              louvre::Node("article"));
+    });
+
+    auto parse_res = parser.parse();
+    massert(std::holds_alternative<std::shared_ptr<louvre::Node>>(parse_res));
+    auto root = std::get<std::shared_ptr<louvre::Node>>(parse_res);
+
+    louvre::Document doc(root);
+    massert(0 == doc.index_of(root).value());
+    massert(doc.subtree_end(0) == doc.size());
+
+    const auto articles = doc.of_type("article");
+    massert(2 == articles.size());
+    massert(2 == doc.with_tag("article").size());
+    massert(doc.node(articles[0]) == root->children().at(0));
+
+    const auto items = doc.of_type(louvre::StandardNodeType::Item);
+    massert(4 == items.size());
+
+    const auto first_items =
+        doc.descendants_of_type(articles[0], louvre::StandardNodeType::Item);
+    massert(3 == first_items.size());
+    massert(*doc.node(first_items[0])->children().at(0)->text() == "One");
+
+    const auto second_items = doc.descendants_with_tag(articles[1], "item");
+    massert(1 == second_items.size());
+    massert(*doc.node(second_items[0])->children().at(0)->text() == "Three");
+
+    massert(doc.descendants_of_type(items[0], "article").empty());
+    massert(doc.of_type("missing").empty());
+
+    const louvre::NodeIndex nested = first_items[2];
+    const auto              chain  = doc.ancestors(nested);
+    massert(5 == chain.size());
+    massert(0 == chain.back());
+    massert(articles[0] == chain[chain.size() - 2]);
+    massert(5 == doc.depth(nested));
+    massert(doc.is_ancestor(articles[0], nested));
+    massert(!doc.is_ancestor(articles[1], nested));
+
+    massert(articles[1] == doc.nth_child(0, 1).value());
+    massert(!doc.nth_child(0, 2));
+    massert(2 == doc.children(0).size());
+    massert(doc.node(doc.parent(nested))
+                ->is(louvre::StandardNodeType::Bullets));
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <louvre/api.hpp>
+#include <louvre/loader.hpp>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+static std::map<std::string, std::optional<std::size_t>>
+load(louvre::FileLoader &loader, const std::vector<std::string> &paths) {
+    std::mutex                                        mutex;
+    std::map<std::string, std::optional<std::size_t>> children;
+
+    // Parses each file as soon as it has been read
+    loader.load(paths,
+                [&](const std::string         &path,
+                    std::optional<std::string> content) {
+                    std::optional<std::size_t> count;
+
+                    if (content) {
+                        auto parser = louvre::Parser(std::move(*content));
+                        auto res    = parser.parse();
+                        count = std::get<std::shared_ptr<louvre::Node>>(res)
+                                    ->children()
+                                    .size();
+                    }
+
+                    std::lock_guard<std::mutex> lock(mutex);
+                    children.emplace(path, count);
+                });
+
+    return children;
+}
+
+int main(void) {
+    const auto dir =
+        std::filesystem::temp_directory_path() / "louvre-file-loader";
+    std::filesystem::create_directories(dir);
+
+    std::vector<std::string> paths;
+    for (int i = 0; i < 200; i++) {
+        const auto path = (dir / (std::to_string(i) + ".lv")).string();
+        std::ofstream(path) << std::string(i * 97, ' ')
+                            << std::string(i, '#');
+        paths.push_back(path);
+    }
+
+    paths.push_back((dir / "missing.lv").string());
+
+    // Uses io_uring where available, and worker threads otherwise
+    louvre::FileLoader ring(4, 8);
+    const auto         ring_res = load(ring, paths);
+
+    louvre::FileLoader pool(4);
+    pool.disable_io_uring();
+    const auto pool_res = load(pool, paths);
+    massert(!pool.used_io_uring());
+
+    massert(paths.size() == ring_res.size());
+    massert(ring_res == pool_res);
+    massert(!ring_res.at(paths.back()).has_value());
+
+    for (int i = 0; i < 200; i++) {
+        // Pairs of # are a text node, and an odd # is a line break
+        const std::size_t expected = (i / 2 > 0) + i % 2;
+        massert(expected == ring_res.at(paths[i]));
+    }
+
+    std::filesystem::remove_all(dir);
+    return 0;
+}
@@ -0,0 +1,124 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <cstddef>
+#include <iostream>
+#include <louvre/api.hpp>
+#include <louvre/document.hpp>
+#include <memory>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+const std::string SOURCE = "#paragraph\n"
+                           "See #ref(second) and #ref(first)\n"
+                           "#label(first)\n"
+                           "#end\n"
+                           "#center\n"
+                           "#paragraph\n"
+                           "#label(second)\n"
+                           "Nested #ref(first)\n"
+                           "#end\n"
+                           "#end\n";
+
+// Bytes of text in the subtree, walked through the frozen view only
+std::size_t text_bytes(const louvre::FrozenDocument &frozen,
+                       louvre::NodeIndex             index) {
+    std::size_t bytes = 0;
+
+    if (const auto &text = frozen.text(index)) {
+        bytes += text->size();
+    }
+
+    for (const auto child : frozen.children(index)) {
+        bytes += text_bytes(frozen, child);
+    }
+
+    return bytes;
+}
+
+int main(void) {
+    auto parser    = louvre::Parser(SOURCE);
+    auto parse_res = parser.parse();
+    massert(std::holds_alternative<std::shared_ptr<louvre::Node>>(parse_res));
+
+    auto root = std::get<std::shared_ptr<louvre::Node>>(parse_res);
+
+    const louvre::FrozenDocument frozen = louvre::Document(root).freeze();
+    const louvre::Document       doc(root);
+    massert(doc.size() == frozen.size());
+
+    for (louvre::NodeIndex i = 0; i < frozen.size(); i++) {
+        massert(doc.node(i).get() == &frozen.node(i));
+        massert(doc.node(i)->type() == frozen.type(i));
+        massert(doc.parent(i) == frozen.parent(i));
+        massert(doc.depth(i) == frozen.depth(i));
+        massert(doc.subtree_end(i) == frozen.subtree_end(i));
+        massert(doc.children(i).size() == frozen.children(i).size());
+
+        const auto tag = doc.node(i)->tag();
+        massert((tag ? tag->get() : nullptr) == frozen.tag(i));
+    }
+
+    const auto references = doc.of_type(louvre::StandardNodeType::Reference);
+    massert(3 == references.size());
+    massert("second" == frozen.tag(references[0])->arguments().front());
+    massert(frozen.node(*frozen.reference(references[0]))
+                .is(louvre::StandardNodeType::Label));
+    massert(frozen.reference(references[1]) == frozen.reference(references[2]));
+    massert(!frozen.reference(0));
+    massert("See" == frozen.text(frozen.children(1).front()).value());
+
+    // The view outlives the parser result and the Document it came from
+    const std::size_t expected = text_bytes(frozen, 0);
+    root.reset();
+    massert(0 < expected);
+
+    std::vector<std::size_t> results(4);
+    std::vector<std::thread> readers;
+    for (std::size_t i = 0; i < results.size(); i++) {
+        readers.emplace_back(
+            [&, i]() { results[i] = text_bytes(frozen, 0); });
+    }
+
+    for (auto &reader : readers) {
+        reader.join();
+    }
+
+    for (const auto result : results) {
+        massert(expected == result);
+    }
+
+    // Lazy blocks are loaded before the view is taken
+    auto lazy      = louvre::Parser(SOURCE);
+    auto lazy_root = std::get<std::shared_ptr<louvre::Node>>(lazy.parse_lazy());
+    massert(!lazy_root->children().at(0)->is_loaded());
+
+    const auto lazy_frozen = louvre::Document(lazy_root).freeze();
+    massert(lazy_root->children().at(0)->is_loaded());
+    massert(frozen.size() == lazy_frozen.size());
+    massert(expected == text_bytes(lazy_frozen, 0));
+
+    return 0;
+}
@@ -0,0 +1,162 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <louvre/api.hpp>
+#include <louvre/include.hpp>
+#include <memory>
+#include <string>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+const std::filesystem::path DIR =
+    std::filesystem::temp_directory_path() / "louvre-include-test";
+
+void write(const std::string &name, const std::string &content) {
+    std::ofstream(DIR / name, std::ios::binary) << content;
+}
+
+std::string read(const std::string &name) {
+    std::ifstream file(DIR / name, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(file)),
+                       std::istreambuf_iterator<char>());
+}
+
+std::string error_of(const std::string &name) {
+    auto parser    = louvre::Parser(read(name), (DIR / name).string());
+    auto parse_res = parser.parse();
+
+    if (auto e = std::get_if<louvre::TagError>(&parse_res)) {
+        return e->message();
+    }
+
+    return "";
+}
+
+int main(void) {
+    std::filesystem::remove_all(DIR);
+    std::filesystem::create_directories(DIR / "parts");
+
+    write("main.lv",
+          "#include(parts/one.lv)\n"
+          "#include( parts/two.lv )\n"
+          "See #ref(shared)\n");
+    write("parts/one.lv", "#paragraph\nOne #include(common.lv)#label(shared)");
+    write("parts/two.lv", "#paragraph\nTwo #include(./common.lv)\n#end\n");
+    write("parts/common.lv", "Common text");
+
+    auto cache  = std::make_shared<louvre::IncludeCache>();
+    auto parser = louvre::Parser(read("main.lv"), (DIR / "main.lv").string());
+    parser.set_include_cache(cache);
+    auto parse_res = parser.parse();
+    massert(std::holds_alternative<std::shared_ptr<louvre::Node>>(parse_res));
+
+    auto root = std::get<std::shared_ptr<louvre::Node>>(parse_res);
+    massert(4 == root->children().size());
+
+    auto one = root->children().at(0);
+    auto two = root->children().at(1);
+    massert(one->is(louvre::StandardNodeType::Paragraph));
+    massert(one->parent().value() == root);
+    massert(0 == one->source_start() && 22 == one->source_end());
+    massert(23 == two->source_start());
+    massert("One" == one->children().at(0)->text().value());
+    massert("Common text" == one->children().at(1)->text().value());
+    massert("Common text" == two->children().at(1)->text().value());
+    massert(one->children().at(1) != two->children().at(1));
+    massert(root->children().at(3)->reference().value() ==
+            one->children().at(2));
+
+    // common.lv is included twice but parsed once, and a second document
+    // sharing the cache parses nothing again
+    massert(3 == cache->parses());
+    auto again = louvre::Parser(read("main.lv"), (DIR / "main.lv").string());
+    again.set_include_cache(cache);
+    massert(std::holds_alternative<std::shared_ptr<louvre::Node>>(
+        again.parse()));
+    massert(3 == cache->parses());
+
+    // Changing a file invalidates it and every file that includes it
+    const auto time = std::filesystem::last_write_time(DIR / "parts/common.lv");
+    write("parts/common.lv", "Changed text");
+    std::filesystem::last_write_time(DIR / "parts/common.lv",
+                                     time + std::chrono::seconds(1));
+    auto changed = louvre::Parser(read("main.lv"), (DIR / "main.lv").string());
+    changed.set_include_cache(cache);
+    auto changed_res  = changed.parse();
+    auto changed_root = std::get<std::shared_ptr<louvre::Node>>(changed_res);
+    massert(6 == cache->parses());
+    massert("Changed text" ==
+            changed_root->children().at(1)->children().at(1)->text().value());
+
+    // The tree of a file depends on the variables of its includer, so it is
+    // not shared with a parser that sets them differently
+    write("greet.lv", "#include(parts/name.lv)");
+    write("parts/name.lv", "Hello #var(name)");
+    std::string names[2] = {"Ada", "Grace"};
+    for (const auto &name : names) {
+        auto greet =
+            louvre::Parser(read("greet.lv"), (DIR / "greet.lv").string());
+        greet.set_include_cache(cache);
+        greet.set_variables({{"name", name}});
+        auto greet_res = greet.parse();
+        auto greeting  = std::get<std::shared_ptr<louvre::Node>>(greet_res)
+                            ->children()
+                            .at(0);
+        massert("Hello " + name == greeting->text().value());
+    }
+    massert(8 == cache->parses());
+
+    write("self.lv", "#include(self.lv)");
+    write("a.lv", "A #include(b.lv)");
+    write("b.lv", "B #include(parts/../a.lv)");
+    write("missing.lv", "#include(nowhere.lv)");
+    massert("Include cycle" == error_of("self.lv"));
+    massert("Include cycle" == error_of("a.lv"));
+    massert("Cannot read included file" == error_of("missing.lv"));
+
+    // Errors in included files point into those files
+    write("bad.lv", "#include(parts/bad.lv)");
+    write("parts/bad.lv", "Text\n  #unknown");
+    auto bad     = louvre::Parser(read("bad.lv"), (DIR / "bad.lv").string());
+    auto bad_res = bad.parse();
+    massert(std::holds_alternative<louvre::TagError>(bad_res));
+
+    auto location = std::get<louvre::TagError>(bad_res).tag()->location();
+    massert(std::filesystem::path(location.path()).filename() == "bad.lv");
+    massert(std::filesystem::path(location.path()).parent_path().filename() ==
+            "parts");
+    massert(1 == location.line() && 3 == location.column());
+
+    // Arguments are not restricted to tag characters
+    auto bullets     = louvre::Parser("#bullets( * , a b )#end");
+    auto bullets_res = bullets.parse();
+    auto list        = std::get<std::shared_ptr<louvre::Node>>(bullets_res);
+    auto tag         = list->children().at(0)->tag().value();
+    massert(2 == tag->arguments().size());
+    massert("*" == tag->arguments().at(0) && "a b" == tag->arguments().at(1));
+
+    std::filesystem::remove_all(DIR);
+    return 0;
+}
@@ -0,0 +1,114 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <iostream>
+#include <louvre/api.hpp>
+#include <louvre/incremental.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+const std::string SOURCE_V1 = "#center\n"
+                              "TITLE\n"
+                              "#end\n"
+                              "#paragraph\n"
+                              "First paragraph\n"
+                              "#end\n"
+                              "#paragraph\n"
+                              "Second paragraph\n"
+                              "#end\n";
+
+const std::string SOURCE_V2 = "#center\n"
+                              "TITLE\n"
+                              "#end\n"
+                              "#paragraph\n"
+                              "First paragraph, edited\n"
+                              "#end\n"
+                              "#paragraph\n"
+                              "Second paragraph\n"
+                              "#end\n";
+
+const std::string SOURCE_V3 = "#center\n"
+                              "TITLE\n"
+                              "#end\n"
+                              "#paragraph\n"
+                              "Second paragraph\n"
+                              "#end\n";
+
+std::string render(std::shared_ptr<louvre::Node> node) {
+    std::string out = "<";
+
+    if (node->text()) {
+        out += *node->text();
+    }
+
+    for (const auto &child : node->children()) {
+        out += render(child);
+    }
+
+    return out + ">";
+}
+
+std::shared_ptr<louvre::Node> parse(const std::string &source) {
+    auto parser = louvre::Parser(source);
+    return std::get<std::shared_ptr<louvre::Node>>(parser.parse());
+}
+
+std::string apply_patches(std::string                       previous,
+                          const std::vector<louvre::Patch> &patches) {
+    for (auto it = patches.rbegin(); it != patches.rend(); it++) {
+        previous.replace(it->offset(), it->length(), it->replacement());
+    }
+
+    return previous;
+}
+
+int main(void) {
+    auto emitter = louvre::IncrementalEmitter(render);
+
+    auto        patches = emitter.emit(parse(SOURCE_V1));
+    std::string preview = apply_patches("", patches);
+    massert(3 == emitter.rendered());
+    massert(preview == emitter.output());
+
+    patches = emitter.emit(parse(SOURCE_V2));
+    massert(1 == emitter.rendered());
+    massert(1 == patches.size());
+    preview = apply_patches(preview, patches);
+    massert(preview == emitter.output());
+
+    auto full = louvre::IncrementalEmitter(render);
+    full.emit(parse(SOURCE_V2));
+    massert(full.output() == emitter.output());
+
+    patches = emitter.emit(parse(SOURCE_V3));
+    massert(0 == emitter.rendered());
+    preview = apply_patches(preview, patches);
+    massert(preview == emitter.output());
+
+    patches = emitter.emit(parse(SOURCE_V3));
+    massert(0 == emitter.rendered());
+    massert(patches.empty());
+
+    return 0;
+}
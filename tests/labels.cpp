@@ -0,0 +1,86 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <iostream>
+#include <louvre/api.hpp>
+#include <memory>
+#include <string>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+const std::string SOURCE = "#paragraph\n"
+                           "See #ref(second) and #ref(first)\n"
+                           "#label(first)\n"
+                           "#end\n"
+                           "#paragraph\n"
+                           "#label(second)\n"
+                           "See #ref(first)\n"
+                           "#end\n";
+
+std::string error_of(const std::string &source) {
+    auto parser    = louvre::Parser(source);
+    auto parse_res = parser.parse();
+
+    if (auto e = std::get_if<louvre::TagError>(&parse_res)) {
+        return e->message();
+    }
+
+    return "";
+}
+
+int main(void) {
+    auto parser    = louvre::Parser(SOURCE);
+    auto parse_res = parser.parse();
+    massert(std::holds_alternative<std::shared_ptr<louvre::Node>>(parse_res));
+
+    auto root   = std::get<std::shared_ptr<louvre::Node>>(parse_res);
+    auto first  = root->children().at(0);
+    auto second = root->children().at(1);
+
+    auto forward  = first->children().at(1);
+    auto backward = first->children().at(3);
+    massert(forward->is(louvre::StandardNodeType::Reference));
+    massert(forward->reference().value()->parent().value() == second);
+    massert(backward->reference().value()->parent().value() == first);
+    massert(second->children().at(2)->reference().value() ==
+            first->children().at(4));
+    massert(2 == parser.labels().size());
+    massert(parser.labels().find("second").value() == second->children().at(0));
+    massert(!parser.labels().find("third"));
+
+    massert("Unresolved reference" == error_of("#ref(missing)"));
+    massert("Duplicate label" == error_of("#label(a) #label(a)"));
+    massert("Expected exactly one argument" == error_of("#label"));
+
+    // Enough labels to force the table to grow a few times
+    std::string many;
+    for (int i = 0; i < 1000; i++) {
+        many += "#ref(l" + std::to_string(999 - i) + ")";
+        many += "#label(l" + std::to_string(i) + ")";
+    }
+
+    auto many_parser = louvre::Parser(many);
+    massert(std::holds_alternative<std::shared_ptr<louvre::Node>>(
+        many_parser.parse()));
+    massert(1000 == many_parser.labels().size());
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <iostream>
+#include <louvre/api.hpp>
+#include <memory>
+#include <string>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+const std::string SOURCE = "#define(note, body) #right #arg(body) #end #end\n"
+                           "Intro ##end text\n"
+                           "#paragraph\n"
+                           "  First #var(name)\n"
+                           "  #bullets(*)\n"
+                           "    #item One #end\n"
+                           "    #item Two #if(x) #end #end\n"
+                           "  #end\n"
+                           "  #note(Noted)\n"
+                           "#end\n"
+                           "#center\n"
+                           "  Second #label(second)\n"
+                           "  #paragraph Unclosed";
+
+bool same(const std::shared_ptr<louvre::Node> &a,
+          const std::shared_ptr<louvre::Node> &b) {
+    if (a->source_start() != b->source_start() ||
+        a->source_end() != b->source_end() ||
+        a->children().size() != b->children().size()) {
+        return false;
+    }
+
+    if (a->tag()) {
+        auto a_location = a->tag().value()->location();
+        auto b_location = b->tag().value()->location();
+
+        if (a_location.line() != b_location.line() ||
+            a_location.column() != b_location.column()) {
+            return false;
+        }
+    }
+
+    for (std::size_t i = 0; i < a->children().size(); i++) {
+        if (!same(a->children().at(i), b->children().at(i))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(void) {
+    auto eager = louvre::Parser(SOURCE);
+    eager.set_variables({{"name", "Louvre"}});
+    auto eager_root = std::get<std::shared_ptr<louvre::Node>>(eager.parse());
+
+    auto lazy = louvre::Parser(SOURCE);
+    lazy.set_variables({{"name", "Louvre"}});
+    auto parse_res = lazy.parse_lazy();
+    massert(std::holds_alternative<std::shared_ptr<louvre::Node>>(parse_res));
+
+    auto root = std::get<std::shared_ptr<louvre::Node>>(parse_res);
+    massert(3 == root->children().size());
+
+    auto paragraph = root->children().at(1);
+    auto center    = root->children().at(2);
+    massert(!paragraph->is_loaded() && !center->is_loaded());
+    massert(eager_root->children().at(1)->source_end() ==
+            paragraph->source_end());
+
+    // Loading a block leaves its siblings and nested blocks alone
+    massert(3 == paragraph->children().size());
+    massert(paragraph->is_loaded() && !center->is_loaded());
+    massert(!paragraph->children().at(1)->is_loaded());
+    massert("First Louvre" == paragraph->children().at(0)->text().value());
+    massert(paragraph->children().at(2)->is(louvre::StandardNodeType::Right));
+
+    // Once everything is loaded, the tree matches an eager parse
+    massert(eager_root->hash() == root->hash());
+    massert(same(eager_root, root));
+    massert(lazy.lazy_errors().empty());
+
+    // Errors inside a block show up when the block is loaded
+    auto bad     = louvre::Parser("Fine #center #unknown #end");
+    auto bad_res = bad.parse_lazy();
+    massert(std::holds_alternative<std::shared_ptr<louvre::Node>>(bad_res));
+    massert(bad.lazy_errors().empty());
+
+    auto block = std::get<std::shared_ptr<louvre::Node>>(bad_res)
+                     ->children()
+                     .at(1);
+    massert(block->children().empty());
+    massert(1 == bad.lazy_errors().size());
+    massert(std::holds_alternative<louvre::TagError>(bad.lazy_errors().at(0)));
+
+    return 0;
+}
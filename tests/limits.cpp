@@ -0,0 +1,154 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <cstddef>
+#include <iostream>
+#include <louvre/api.hpp>
+#include <memory>
+#include <string>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+static bool
+exceeds(const std::string &source, louvre::Limit limit, std::size_t value) {
+    auto parser = louvre::Parser(source);
+    parser.set_limit(limit, value);
+    auto res = parser.parse();
+
+    return std::holds_alternative<louvre::LimitError>(res) &&
+           limit == std::get<louvre::LimitError>(res).limit();
+}
+
+static bool
+fits(const std::string &source, louvre::Limit limit, std::size_t value) {
+    auto parser = louvre::Parser(source);
+    parser.set_limit(limit, value);
+    return std::holds_alternative<std::shared_ptr<louvre::Node>>(
+        parser.parse());
+}
+
+static void materialize(const std::shared_ptr<louvre::Node> &node) {
+    for (const auto &child : node->children()) {
+        materialize(child);
+    }
+}
+
+// Lazily parsed blocks report limits once they are materialized
+static bool lazy_exceeds(const std::string &source,
+                         louvre::Limit      limit,
+                         std::size_t        value) {
+    auto parser = louvre::Parser(source);
+    parser.set_limit(limit, value);
+    auto res = parser.parse_lazy();
+
+    if (!std::holds_alternative<std::shared_ptr<louvre::Node>>(res)) {
+        return std::holds_alternative<louvre::LimitError>(res) &&
+               limit == std::get<louvre::LimitError>(res).limit();
+    }
+
+    materialize(std::get<std::shared_ptr<louvre::Node>>(res));
+
+    for (const auto &error : parser.lazy_errors()) {
+        if (std::holds_alternative<louvre::LimitError>(error) &&
+            limit == std::get<louvre::LimitError>(error).limit()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int main(void) {
+    const std::string nested = "#left #center #right Text #end #end #end";
+    massert(fits(nested, louvre::Limit::Depth, 3));
+    massert(exceeds(nested, louvre::Limit::Depth, 2));
+
+    // Closed blocks do not count towards the depth
+    const std::string siblings = "#left A #end #left B #end #left C #end";
+    massert(fits(siblings, louvre::Limit::Depth, 1));
+
+    massert(fits(siblings, louvre::Limit::Nodes, 6));
+    massert(exceeds(siblings, louvre::Limit::Nodes, 5));
+
+    // #end is a tag too
+    massert(fits(siblings, louvre::Limit::Tags, 6));
+    massert(exceeds(siblings, louvre::Limit::Tags, 5));
+
+    massert(fits("#left Some text #end", louvre::Limit::TextLength, 10));
+    massert(exceeds("#left Some text #end", louvre::Limit::TextLength, 8));
+
+    massert(fits("#define(m, a, b) #end", louvre::Limit::Arguments, 3));
+    massert(exceeds("#define(m, a, b) #end", louvre::Limit::Arguments, 2));
+
+    // Nodes spliced by macros count as well as the template they come from
+    const std::string macro =
+        "#define(twice, x) #left #arg(x) #end #left #arg(x) #end #end "
+        "#twice(a) #twice(b)";
+    massert(fits(macro, louvre::Limit::Nodes, 13));
+    massert(exceeds(macro, louvre::Limit::Nodes, 12));
+
+    // Macros that expand each other are counted before they are cloned, in
+    // definitions too, so they cannot grow past the limits
+    std::string macros = "#define(a0) x #end ";
+    for (int i = 1; i <= 7; i++) {
+        macros += "#define(a" + std::to_string(i) + ") ";
+        for (int j = 0; j < 10; j++) {
+            macros += "#a" + std::to_string(i - 1) + " ";
+        }
+        macros += "#end ";
+    }
+
+    massert(exceeds(macros, louvre::Limit::Nodes, 1000));
+    massert(exceeds(macros, louvre::Limit::Memory, 1024 * 1024));
+    massert(exceeds(macros + "#a7", louvre::Limit::Nodes, 1000));
+
+    // Lazy mode enforces the same limits across deferred blocks
+    std::string deep;
+    for (int i = 0; i < 50; i++) {
+        deep += "#left ";
+    }
+
+    massert(exceeds(deep, louvre::Limit::Depth, 3));
+    massert(lazy_exceeds(deep, louvre::Limit::Depth, 3));
+    massert(!lazy_exceeds(nested, louvre::Limit::Depth, 3));
+    massert(lazy_exceeds(nested, louvre::Limit::Depth, 2));
+    massert(!lazy_exceeds(siblings, louvre::Limit::Nodes, 6));
+    massert(lazy_exceeds(siblings, louvre::Limit::Nodes, 5));
+    massert(!lazy_exceeds(siblings, louvre::Limit::Tags, 6));
+    massert(lazy_exceeds(siblings, louvre::Limit::Tags, 5));
+
+    // Fails fast on a document made only of line breaks
+    std::string breaks;
+    for (int i = 0; i < 1000000; i++) {
+        breaks += "# ";
+    }
+
+    auto parser = louvre::Parser(breaks);
+    parser.set_limit(louvre::Limit::Memory, 64 * 1024);
+    auto res = parser.parse();
+    massert(std::holds_alternative<louvre::LimitError>(res));
+
+    const auto error = std::get<louvre::LimitError>(res);
+    massert(louvre::Limit::Memory == error.limit());
+    massert(error.location().global_offset() < breaks.length() / 100);
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <louvre/linebreak.hpp>
+#include <louvre/width.hpp>
+#include <string>
+#include <vector>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+double line_cost(std::size_t line_width, std::size_t width) {
+    if (line_width > width) {
+        return 1e10 * (line_width - width);
+    }
+
+    return double(width - line_width) * double(width - line_width);
+}
+
+double layout_cost(const std::vector<louvre::Line> &lines, std::size_t width) {
+    double cost = 0;
+
+    for (std::size_t i = 0; i + 1 < lines.size(); i++) {
+        cost += line_cost(lines[i].width(), width);
+    }
+
+    // The last line is free unless it overflows
+    if (!lines.empty() && lines.back().width() > width) {
+        cost += line_cost(lines.back().width(), width);
+    }
+
+    return cost;
+}
+
+// Quadratic reference implementation of the total fit objective
+double reference_cost(const std::vector<std::size_t> &widths,
+                      std::size_t                     width) {
+    const std::size_t   n = widths.size();
+    std::vector<double> best(n + 1, std::numeric_limits<double>::infinity());
+    best[0] = 0;
+
+    for (std::size_t j = 1; j <= n; j++) {
+        std::size_t line = 0;
+
+        for (std::size_t i = j; i-- > 0;) {
+            line += widths[i] + (i + 1 == j ? 0 : 1);
+            const double cost =
+                best[i] + ((j == n && line <= width) ? 0
+                                                     : line_cost(line, width));
+            best[j] = std::min(best[j], cost);
+        }
+    }
+
+    return best[n];
+}
+
+std::string random_word(std::size_t length) {
+    std::string word;
+    for (std::size_t i = 0; i < length; i++) {
+        word.push_back('a' + rand() % 26);
+    }
+
+    return word;
+}
+
+int main(void) {
+    louvre::LineBreaker breaker;
+
+    const std::string text = "aaa bb cc ddddd";
+    auto greedy = breaker.break_words(louvre::LineBreaker::split_words(text),
+                                      6,
+                                      louvre::BreakMode::Greedy);
+    massert(3 == greedy.size());
+    massert(0 == greedy[0].first() && 2 == greedy[0].last());
+    massert(6 == greedy[0].width());
+
+    auto fit = breaker.break_words(louvre::LineBreaker::split_words(text),
+                                   6,
+                                   louvre::BreakMode::TotalFit);
+    massert(3 == fit.size());
+    massert(1 == fit[0].last() && 3 == fit[1].last());
+    massert(layout_cost(fit, 6) < layout_cost(greedy, 6));
+
+    for (const auto &line : breaker.justify(
+             "The quick brown fox jumps over the lazy dog and then some",
+             20)) {
+        massert(louvre::display_width(line) <= 20);
+    }
+
+    auto lines = breaker.justify("aa bb cc dddddddd e", 8);
+    massert(3 == lines.size());
+    massert("aa bb cc" == lines[0]);
+    massert("dddddddd" == lines[1]);
+    massert("e" == lines[2]);
+
+    lines = breaker.justify("aa bb c dd ee", 9);
+    massert(2 == lines.size());
+    massert("aa  bb  c" == lines[0]);
+    massert("dd ee" == lines[1]);
+
+    massert(breaker.break_words({}, 10, louvre::BreakMode::TotalFit).empty());
+
+    for (int round = 0; round < 200; round++) {
+        const std::size_t        width = 10 + rand() % 30;
+        std::vector<std::string> storage;
+        std::vector<std::size_t> widths;
+
+        for (int i = 0, n = 1 + rand() % 120; i < n; i++) {
+            storage.push_back(random_word(1 + rand() % 12));
+            widths.push_back(storage.back().length());
+        }
+
+        std::vector<std::string_view> words(storage.begin(), storage.end());
+        const auto                    layout =
+            breaker.break_words(words, width, louvre::BreakMode::TotalFit);
+
+        massert(layout.front().first() == 0);
+        massert(layout.back().last() == words.size());
+        for (std::size_t i = 1; i < layout.size(); i++) {
+            massert(layout[i].first() == layout[i - 1].last());
+        }
+
+        massert(layout_cost(layout, width) == reference_cost(widths, width));
+    }
+
+    return 0;
+}
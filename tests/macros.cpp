@@ -0,0 +1,121 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <iostream>
+#include <louvre/api.hpp>
+#include <memory>
+#include <string>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+const std::string SOURCE = "#define(section, title, body)\n"
+                           "#paragraph\n"
+                           "#center #arg(title) #end\n"
+                           "#arg(body) and more\n"
+                           "#end\n"
+                           "#end\n"
+                           "#section(First, Some text)\n"
+                           "#section(Second, Other text)\n"
+                           "#section(First, Some text)\n";
+
+std::string error_of(const std::string &source) {
+    auto parser    = louvre::Parser(source);
+    auto parse_res = parser.parse();
+
+    if (auto e = std::get_if<louvre::TagError>(&parse_res)) {
+        return e->message();
+    }
+
+    return "";
+}
+
+int main(void) {
+    auto parser = louvre::Parser(SOURCE);
+    parser.collect_toc({louvre::StandardNodeType::Center});
+    auto parse_res = parser.parse();
+    massert(std::holds_alternative<std::shared_ptr<louvre::Node>>(parse_res));
+
+    auto root = std::get<std::shared_ptr<louvre::Node>>(parse_res);
+    massert(3 == root->children().size());
+
+    auto first  = root->children().at(0);
+    auto second = root->children().at(1);
+    auto third  = root->children().at(2);
+    massert(first->is(louvre::StandardNodeType::Paragraph));
+    massert(first->parent().value() == root);
+    massert(3 == first->children().size());
+    massert("First" ==
+            first->children().at(0)->children().at(0)->text().value());
+    massert("Some text" == first->children().at(1)->text().value());
+    massert("and more" == first->children().at(2)->text().value());
+    massert("Other text" == second->children().at(1)->text().value());
+
+    // Identical invocations share an expansion but not their nodes
+    massert(first->hash() == third->hash());
+    massert(first->children().at(1) != third->children().at(1));
+    massert(third->children().at(1)->parent().value() == third);
+
+    // Expanded nodes point back to their invocation
+    massert(SOURCE.find("#section(Second") == second->source_start());
+    massert(SOURCE.find("\n#section(First", second->source_start()) ==
+            second->source_end());
+
+    // Expansions go through the table of contents like any other node
+    massert(3 == parser.toc().size());
+    massert("Second" == parser.toc().title(1));
+
+    // Labels in the body are only indexed once the macro is expanded
+    auto labels = louvre::Parser("#define(anchor, name) #label(x) #end\n"
+                                 "#ref(x) #anchor(a)");
+    massert(std::holds_alternative<std::shared_ptr<louvre::Node>>(
+        labels.parse()));
+    massert(1 == labels.labels().size());
+    massert("Duplicate label" ==
+            error_of("#define(anchor) #label(x) #end #anchor #anchor"));
+
+    // The error of a second invocation points at the name of the #label in
+    // the body
+    const std::string twice = "#define(anchor) #label(x) #end\n"
+                              "#anchor #anchor";
+    auto twice_res          = louvre::Parser(twice).parse();
+    massert(std::holds_alternative<louvre::TagError>(twice_res));
+
+    const auto duplicate = std::get<louvre::TagError>(twice_res).tag();
+    massert(twice.find("label(x)") == duplicate->location().global_offset());
+
+    massert("Unresolved reference" ==
+            error_of("#define(anchor) #label(x) #end #ref(x)"));
+
+    massert("Expected 2 arguments" ==
+            error_of("#define(m, a, b) #arg(a) #end #m(x)"));
+    massert("Unknown macro parameter" ==
+            error_of("#define(m, a) #arg(b) #end"));
+    massert("Argument outside of macro definition" == error_of("#arg(a)"));
+    massert("Nested macro definition" ==
+            error_of("#define(m) #define(n) #end #end"));
+    massert("Tag already defined" == error_of("#define(paragraph) #end"));
+    massert("Tag already defined" ==
+            error_of("#define(m) #end #define(m) #end"));
+    massert("Unterminated macro definition" == error_of("#define(m) text"));
+    massert("Unknown tag" == error_of("#define(m) #m #end"));
+
+    return 0;
+}
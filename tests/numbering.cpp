@@ -0,0 +1,96 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <iostream>
+#include <louvre/api.hpp>
+#include <louvre/numbering.hpp>
+#include <memory>
+#include <string>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+const std::string SOURCE = "#article\n"
+                           "#numbers\n"
+                           "#item First #end\n"
+                           "#item Second\n"
+                           "#numbers\n"
+                           "#item Nested\n"
+                           "#numbers\n"
+                           "#item Deep #end\n"
+                           "#end\n"
+                           "#end\n"
+                           "#end\n"
+                           "#end\n"
+                           "#end\n"
+                           "#bullets\n"
+                           "#item Bullet #end\n"
+                           "#end\n"
+                           "#end\n"
+                           "#article\n"
+                           "#article Nested article #end\n"
+                           "#numbers\n"
+                           "#item Restarted #end\n"
+                           "#end\n"
+                           "#end\n";
+
+int main(void) {
+    auto parser = louvre::Parser(SOURCE);
+    parser.add_tag_binding("article", [](std::shared_ptr<louvre::Tag> tag) {
+        return std::make_pair(louvre::ParserAction::AddChildAndBranch,
+                              louvre::Node("article"));
+    });
+
+    auto parse_res = parser.parse();
+    massert(std::holds_alternative<std::shared_ptr<louvre::Node>>(parse_res));
+    auto root = std::get<std::shared_ptr<louvre::Node>>(parse_res);
+
+    louvre::Numbering numbering;
+    numbering.add_counter("article");
+    numbering.compute(root);
+
+    auto article1 = root->children().at(0);
+    auto numbers  = article1->children().at(0);
+    auto first    = numbers->children().at(0);
+    auto second   = numbers->children().at(1);
+    auto nested   = second->children().at(1)->children().at(0);
+    auto deep     = nested->children().at(1)->children().at(0);
+    auto bullet   = article1->children().at(1)->children().at(0);
+    auto article2 = root->children().at(1);
+    auto article3 = article2->children().at(0);
+    auto restart  = article2->children().at(1)->children().at(0);
+
+    massert("1" == numbering.format(article1));
+    massert("1" == numbering.format(first));
+    massert("2" == numbering.format(second));
+    massert("2.1" == numbering.format(nested));
+    massert("2.1.a" == numbering.format(deep));
+    massert(numbering.of(bullet).empty());
+    massert("2" == numbering.format(article2));
+    massert("2.1" == numbering.format(article3));
+    massert("1" == numbering.format(restart));
+    massert("II-A" == numbering.format(article3,
+                                       {louvre::NumberStyle::UpperRoman,
+                                        louvre::NumberStyle::UpperAlpha},
+                                       "-"));
+    massert(0 == louvre::Node(louvre::StandardNodeType::Text).number());
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "cache.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <iostream>
+#include <louvre/include.hpp>
+#include <string>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+static louvre::cli::Cached cached(std::filesystem::file_time_type time,
+                                  std::size_t                     size) {
+    return louvre::cli::Cached{
+        time, {}, louvre::cli::Response{false, size, std::string(size, 'a')}};
+}
+
+int main(void) {
+    const auto           now = std::filesystem::file_time_type::clock::now();
+    louvre::IncludeCache includes;
+
+    // Two outputs fit in the budget, and the least recently used one makes
+    // room for a third
+    louvre::cli::OutputCache cache(2500);
+    cache.insert("a", cached(now, 1000));
+    cache.insert("b", cached(now, 1000));
+    massert(2 == cache.count());
+    massert(cache.find("a", now, includes));
+
+    cache.insert("c", cached(now, 1000));
+    massert(2 == cache.count() && cache.size() <= 2500);
+    massert(cache.find("a", now, includes));
+    massert(!cache.find("b", now, includes));
+    massert(cache.find("c", now, includes));
+
+    // Replacing an output does not count it twice
+    const std::size_t size = cache.size();
+    cache.insert("c", cached(now, 1000));
+    massert(2 == cache.count() && size == cache.size());
+
+    // Outputs larger than the whole budget are not cached
+    cache.insert("d", cached(now, 5000));
+    massert(!cache.find("d", now, includes));
+    massert(2 == cache.count());
+
+    // Outputs of files written since, or whose includes changed, are stale
+    // and dropped
+    massert(!cache.find("a", now + std::chrono::seconds(1), includes));
+    massert(1 == cache.count());
+
+    auto with_include = cached(now, 10);
+    with_include.mIncludes.emplace_back("/missing.lv", 0);
+    cache.insert("e", std::move(with_include));
+    massert(!cache.find("e", now, includes));
+    massert(1 == cache.count());
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <cstddef>
+#include <iostream>
+#include <louvre/api.hpp>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+class Report {
+    public:
+    std::size_t                mConsumed;
+    std::optional<std::size_t> mTotal;
+    std::size_t                mNodes;
+};
+
+int main(void) {
+    std::string source;
+    for (int i = 0; i < 1000; i++) {
+        source += "#paragraph Some text #end\n";
+    }
+
+    std::vector<Report> reports;
+    auto                parser = louvre::Parser(source);
+    parser.set_progress(
+        [&reports](std::size_t                consumed,
+                   std::optional<std::size_t> total,
+                   std::size_t                nodes) {
+            reports.push_back(Report{consumed, total, nodes});
+        },
+        4096);
+
+    auto res = parser.parse();
+    massert(std::holds_alternative<std::shared_ptr<louvre::Node>>(res));
+
+    // One report every 4096 bytes, plus the final one
+    massert(source.length() / 4096 + 1 == reports.size());
+
+    for (std::size_t i = 0; i < reports.size(); i++) {
+        massert(source.length() == reports[i].mTotal);
+
+        if (i > 0) {
+            massert(reports[i].mConsumed >= reports[i - 1].mConsumed + 4096 ||
+                    i == reports.size() - 1);
+            massert(reports[i].mNodes > reports[i - 1].mNodes);
+        }
+    }
+
+    massert(source.length() == reports.back().mConsumed);
+    massert(2000 == reports.back().mNodes);
+
+    // A single long run of text reports as it goes
+    reports.clear();
+    const std::string run(100000, 'a');
+    auto              text = louvre::Parser(run);
+    text.set_progress(
+        [&reports](std::size_t                consumed,
+                   std::optional<std::size_t> total,
+                   std::size_t                nodes) {
+            reports.push_back(Report{consumed, total, nodes});
+        },
+        4096);
+
+    massert(std::holds_alternative<std::shared_ptr<louvre::Node>>(
+        text.parse()));
+    massert(run.length() / 4096 + 1 == reports.size());
+    massert(4096 == reports.front().mConsumed);
+
+    // Failed parses do not report completion
+    reports.clear();
+    auto failing = louvre::Parser("#paragraph Some text #unknown");
+    failing.set_progress(
+        [&reports](std::size_t                consumed,
+                   std::optional<std::size_t> total,
+                   std::size_t                nodes) {
+            reports.push_back(Report{consumed, total, nodes});
+        },
+        1);
+
+    massert(!std::holds_alternative<std::shared_ptr<louvre::Node>>(
+        failing.parse()));
+    massert(!reports.empty());
+    massert(reports.back().mConsumed < 29);
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <iostream>
+#include <louvre/api.hpp>
+#include <memory>
+#include <string>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+louvre::Schema make_schema() {
+    louvre::Schema schema;
+    schema.allow(louvre::StandardNodeType::Bullets,
+                 louvre::StandardNodeType::Item);
+    schema.allow(louvre::StandardNodeType::Numebrs,
+                 louvre::StandardNodeType::Item);
+    schema.allow(louvre::StandardNodeType::Root, "chapter");
+    schema.set_argument_count("chapter", 1, 1);
+    schema.set_max_depth(4);
+    return schema;
+}
+
+std::variant<std::shared_ptr<louvre::Node>,
+             louvre::SyntaxError,
+             louvre::TagError,
+             louvre::NodeError,
+             louvre::CancelledError,
+             louvre::LimitError>
+parse(const std::string &source) {
+    auto parser = louvre::Parser(source);
+    parser.add_tag_binding("chapter", [](std::shared_ptr<louvre::Tag> tag) {
+        return std::make_pair(louvre::ParserAction::AddChildAndBranch,
+                              louvre::Node("chapter"));
+    });
+    parser.set_schema(make_schema());
+    return parser.parse();
+}
+
+std::string error_of(const std::string &source) {
+    auto parse_res = parse(source);
+
+    if (auto e = std::get_if<louvre::NodeError>(&parse_res)) {
+        return e->message() + " at " +
+               std::to_string(e->node()->tag().value()->location().line()) +
+               ":" +
+               std::to_string(e->node()->tag().value()->location().column());
+    }
+
+    return "";
+}
+
+int main(void) {
+    auto parse_res = parse("#chapter(one)\n"
+                           "#numbers #item A #end #end\n"
+                           "#bullets #item B #end #end\n"
+                           "#end\n");
+    massert(std::holds_alternative<std::shared_ptr<louvre::Node>>(parse_res));
+
+    massert("Node not allowed in this parent at 1:12" ==
+            error_of("#chapter(one)\n#paragraph #item A #end #end #end"));
+    massert("Node not allowed in this parent at 0:12" ==
+            error_of("#paragraph #chapter(one) #end #end"));
+    massert("Unexpected number of arguments at 0:1" ==
+            error_of("#chapter(one, two) #end"));
+    massert("Maximum nesting depth exceeded at 0:34" ==
+            error_of("#chapter(x) #numbers #item #left #center #end #end #end "
+                     "#end #end"));
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <louvre/api.hpp>
+#include <louvre/incremental.hpp>
+#include <louvre/sourcemap.hpp>
+#include <louvre/text.hpp>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+const std::string SOURCE = "#center TITLE #end\n"
+                           "#paragraph Some text #end\n";
+
+std::string render(std::shared_ptr<louvre::Node> node) {
+    std::string out = node->text().value_or("");
+
+    for (const auto &child : node->children()) {
+        out += render(child);
+    }
+
+    return out + "\n";
+}
+
+int main(void) {
+    louvre::SourceMap                                map;
+    std::vector<std::pair<std::size_t, std::size_t>> pairs;
+    std::size_t                                      output = 0;
+
+    massert(!map.to_source(0));
+    massert(!map.to_output(0));
+
+    for (int i = 0; i < 1000; i++) {
+        output += rand() % 3;
+        const std::size_t source = rand() % 5000;
+        map.add(output + 10, source);
+        pairs.push_back(std::make_pair(output + 10, source));
+    }
+
+    massert(1000 == map.size());
+    massert(map.encoded_size() < 1000 * 2 * sizeof(std::size_t) / 4);
+    massert(!map.to_source(9));
+
+    for (std::size_t probe = 0; probe < output + 20; probe++) {
+        std::optional<std::size_t> expected;
+        for (const auto &[out, src] : pairs) {
+            if (out <= probe) {
+                expected = src;
+            }
+        }
+
+        massert(expected == map.to_source(probe));
+    }
+
+    // Once by scanning the encoded map, once through the finalized index
+    for (int pass = 0; pass < 2; pass++) {
+        for (std::size_t probe = 0; probe < 5000; probe += 7) {
+            std::optional<std::size_t> expected;
+            std::size_t                best = 0;
+            for (const auto &[out, src] : pairs) {
+                if (src <= probe && (!expected || src >= best)) {
+                    best     = src;
+                    expected = out;
+                }
+            }
+
+            massert(expected == map.to_output(probe));
+        }
+
+        map.finalize();
+    }
+
+    auto emitter = louvre::IncrementalEmitter(render);
+    emitter.enable_source_map();
+
+    auto parser = louvre::Parser(SOURCE);
+    emitter.emit(std::get<std::shared_ptr<louvre::Node>>(parser.parse()));
+    massert("TITLE\n\nSome text\n\n" == emitter.output());
+    massert(2 == emitter.source_map().size());
+    massert(SOURCE.find("#paragraph") ==
+            emitter.source_map().to_source(emitter.output().find("Some")));
+    massert(emitter.output().find("Some") ==
+            emitter.source_map().to_output(SOURCE.find("#paragraph")));
+
+    // The text emitter maps each block and each text run, and renders the
+    // same output with or without a map
+    louvre::SourceMap map_text;
+    const auto        root = std::get<std::shared_ptr<louvre::Node>>(
+        louvre::Parser(SOURCE).parse());
+    const std::string text =
+        louvre::TextEmitter(20, louvre::BreakMode::TotalFit, &map_text)
+            .emit(root);
+    massert(louvre::TextEmitter(20).emit(root) == text);
+    massert(4 == map_text.size());
+    massert(SOURCE.find("#center") == map_text.to_source(0));
+    massert(SOURCE.find("TITLE") == map_text.to_source(text.find("TITLE")));
+    massert(SOURCE.find("#paragraph") ==
+            map_text.to_source(text.find("Some") - 1));
+    massert(SOURCE.find("Some") == map_text.to_source(text.find("text")));
+    massert(text.find("Some") == map_text.to_output(SOURCE.find("Some")));
+
+    return 0;
+}
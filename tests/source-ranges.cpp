@@ -0,0 +1,78 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <iostream>
+#include <louvre/api.hpp>
+#include <louvre/document.hpp>
+#include <memory>
+#include <string>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+const std::string SOURCE = "#center\n"
+                           "TITLE\n"
+                           "#end\n"
+                           "#justify\n"
+                           "Some text #\n"
+                           "#paragraph\n"
+                           "Indented\n"
+                           "#end\n"
+                           "#end\n";
+
+int main(void) {
+    auto parser    = louvre::Parser(SOURCE);
+    auto parse_res = parser.parse();
+    massert(std::holds_alternative<std::shared_ptr<louvre::Node>>(parse_res));
+    auto root = std::get<std::shared_ptr<louvre::Node>>(parse_res);
+
+    auto center    = root->children().at(0);
+    auto title     = center->children().at(0);
+    auto justify   = root->children().at(1);
+    auto text      = justify->children().at(0);
+    auto linebreak = justify->children().at(1);
+    auto paragraph = justify->children().at(2);
+
+    massert(0 == root->source_start());
+    massert(SOURCE.length() == root->source_end());
+    massert(0 == center->source_start());
+    massert(SOURCE.find("#justify") - 1 == center->source_end());
+    massert(SOURCE.find("TITLE") == title->source_start());
+    massert(SOURCE.find("TITLE") + 5 == title->source_end());
+    massert(SOURCE.find("Some text") + 9 == text->source_end());
+    massert(SOURCE.find("#\n#paragraph") == linebreak->source_start());
+    massert(SOURCE.length() - 1 == justify->source_end());
+
+    louvre::Document doc(root);
+    massert(doc.node(*doc.node_at(SOURCE.find("ITLE"))) == title);
+    massert(doc.node(*doc.node_at(SOURCE.find("#center") + 2)) == center);
+    massert(doc.node(*doc.node_at(SOURCE.find("dented"))) ==
+            paragraph->children().at(0));
+    massert(doc.node(*doc.node_at(SOURCE.find("TITLE") - 1)) == center);
+    massert(doc.node(*doc.node_at(SOURCE.length() - 1)) == root);
+    massert(!doc.node_at(SOURCE.length()));
+
+    // Unclosed blocks run to the end of the source
+    auto open = louvre::Parser("#paragraph Unclosed");
+    auto open_root = std::get<std::shared_ptr<louvre::Node>>(open.parse());
+    massert(19 == open_root->children().at(0)->source_end());
+
+    return 0;
+}
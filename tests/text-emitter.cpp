@@ -0,0 +1,63 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <iostream>
+#include <louvre/api.hpp>
+#include <louvre/text.hpp>
+#include <memory>
+#include <string>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+static std::string render(const std::string &source, std::size_t width) {
+    auto parser = louvre::Parser(source);
+    auto root   = std::get<std::shared_ptr<louvre::Node>>(parser.parse());
+    return louvre::TextEmitter(width).emit(root);
+}
+
+int main(void) {
+    massert("one two\nthree\n" == render("one two three", 8));
+    massert("   ab\n" == render("#right ab #end", 5));
+    massert(" ab\n" == render("#center ab #end", 5));
+
+    // Every line but the last one is padded to the full width
+    massert("a  b\nc\n" == render("#justify a b c #end", 4));
+
+    // A line break ends the line, or makes an empty line on its own
+    massert("a\n\nb\n" == render("a # # b", 10));
+
+    massert("x\n    indented\n    text\ny\n" ==
+            render("x #paragraph indented text #end y", 12));
+
+    massert("1. a\n2. b\n   c\n" ==
+            render("#numbers #item a #end #item b c #end #end", 4));
+    massert("* a\n- b\n" ==
+            render("#bullets(*) #item a #end #end "
+                   "#bullets #item b #end #end",
+                   10));
+
+    // Nested items are numbered hierarchically
+    massert("1. a\n   1.1. b\n" ==
+            render("#numbers #item a #numbers #item b #end #end #end #end",
+                   20));
+
+    return 0;
+}
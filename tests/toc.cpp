@@ -0,0 +1,76 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <iostream>
+#include <louvre/api.hpp>
+#include <memory>
+#include <string>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+const std::string SOURCE = "#section\n"
+                           "Introduction\n"
+                           "#paragraph Some text #end\n"
+                           "#section\n"
+                           "#center Not a heading #end\n"
+                           "Background\n"
+                           "#end\n"
+                           "#end\n"
+                           "#section\n"
+                           "#section Nested first #end\n"
+                           "Conclusion\n"
+                           "#end\n";
+
+int main(void) {
+    auto parser = louvre::Parser(SOURCE);
+    parser.add_tag_binding("section", [](std::shared_ptr<louvre::Tag> tag) {
+        return std::make_pair(louvre::ParserAction::AddChildAndBranch,
+                              louvre::Node("section"));
+    });
+    parser.collect_toc({"section"});
+
+    auto parse_res = parser.parse();
+    massert(std::holds_alternative<std::shared_ptr<louvre::Node>>(parse_res));
+    auto root = std::get<std::shared_ptr<louvre::Node>>(parse_res);
+
+    const auto &toc = parser.toc();
+    massert(4 == toc.size());
+
+    massert(0 == toc.depth(0));
+    massert("Introduction" == toc.title(0));
+    massert(root->children().at(0) == toc.node(0));
+
+    massert(1 == toc.depth(1));
+    massert("Background" == toc.title(1));
+
+    massert(0 == toc.depth(2));
+    massert("Conclusion" == toc.title(2));
+    massert(root->children().at(1) == toc.node(2));
+
+    massert(1 == toc.depth(3));
+    massert("Nested first" == toc.title(3));
+
+    auto plain = louvre::Parser("#center Title #end");
+    plain.parse();
+    massert(0 == plain.toc().size());
+
+    return 0;
+}
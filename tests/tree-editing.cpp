@@ -0,0 +1,133 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <iostream>
+#include <louvre/api.hpp>
+#include <louvre/document.hpp>
+#include <louvre/edit.hpp>
+#include <louvre/text.hpp>
+#include <memory>
+#include <string>
+#include <variant>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+const std::string SOURCE = "#paragraph\n"
+                           "First\n"
+                           "#end\n"
+                           "#center\n"
+                           "Title\n"
+                           "#paragraph Nested #end\n"
+                           "#end\n";
+
+std::shared_ptr<louvre::Node> text(const std::string &content) {
+    return std::make_shared<louvre::Node>(louvre::Node::text(content));
+}
+
+int main(void) {
+    auto parser    = louvre::Parser(SOURCE);
+    auto parse_res = parser.parse();
+    massert(std::holds_alternative<std::shared_ptr<louvre::Node>>(parse_res));
+
+    const louvre::TreeVersion v0(
+        std::get<std::shared_ptr<louvre::Node>>(parse_res));
+    const std::size_t hash = v0.root()->hash();
+    massert("Nested" == v0.at({1, 1, 0}).value()->text().value());
+
+    const auto v1 = v0.replace({1, 1, 0}, text("Edited"));
+    massert(v1);
+    massert("Edited" == v1->at({1, 1, 0}).value()->text().value());
+    massert(v1->at({1, 1, 0}).value()->parent() == v1->at({1, 1}));
+
+    // The old version is untouched, and only the path was copied
+    massert(hash == v0.root()->hash());
+    massert("Nested" == v0.at({1, 1, 0}).value()->text().value());
+    massert(v0.root() != v1->root());
+    massert(v0.at({1}) != v1->at({1}));
+    massert(v0.at({1, 1}) != v1->at({1, 1}));
+    massert(v0.at({0}) == v1->at({0}));
+    massert(v0.at({1, 0}) == v1->at({1, 0}));
+
+    const auto v2 = v1->insert({0}, 1, text("Second"));
+    massert(v2);
+    massert(2 == v2->at({0}).value()->children().size());
+    massert("Second" == v2->at({0, 1}).value()->text().value());
+    massert(1 == v2->at({0, 1}).value()->number());
+    massert(1 == v1->at({0}).value()->children().size());
+    massert(v1->at({1}) == v2->at({1}));
+
+    const auto v3 = v2->remove({1});
+    massert(v3);
+    massert(1 == v3->root()->children().size());
+    massert(2 == v2->root()->children().size());
+    massert(v2->at({0}) == v3->at({0}));
+
+    // Only the edited text differs in the output
+    std::string expected = louvre::TextEmitter(20).emit(v0.root());
+    expected.replace(expected.find("Nested"), 6, "Edited");
+    massert(louvre::TextEmitter(20).emit(v1->root()) == expected);
+
+    // Invalid paths
+    massert(!v0.at({0, 0, 0}));
+    massert(!v0.replace({5}, text("None")));
+    massert(!v0.insert({0}, 2, text("None")));
+    massert(!v0.remove({}));
+    massert(!v0.remove({1, 2}));
+    massert(hash == v0.root()->hash());
+
+    // A container replaced by one that shares its children renders like a
+    // fresh parse of the edited source
+    auto list = louvre::Parser("#bullets(*) #item alpha #end #end");
+    auto plus = louvre::Parser("#bullets(+) #item alpha #end #end");
+    const louvre::TreeVersion stars(
+        std::get<std::shared_ptr<louvre::Node>>(list.parse()));
+    const auto fresh = std::get<std::shared_ptr<louvre::Node>>(plus.parse());
+
+    auto bullets = fresh->children().front()->copy();
+    bullets->set_children(stars.at({0}).value()->children());
+    const auto pluses = stars.replace({0}, bullets);
+    massert(pluses);
+    massert(pluses->at({0, 0}) == stars.at({0, 0}));
+    massert(louvre::TextEmitter(20).emit(pluses->root()) ==
+            louvre::TextEmitter(20).emit(fresh));
+    massert(louvre::TextEmitter(20).emit(stars.root()) == "* alpha\n");
+
+    // References in an edited version find the labels of that version
+    auto labels = louvre::Parser("#label(a) #left #ref(a) #end");
+    const louvre::TreeVersion original(
+        std::get<std::shared_ptr<louvre::Node>>(labels.parse()));
+    const auto relabeled =
+        original.replace({0}, original.at({0}).value()->copy());
+    massert(relabeled);
+
+    const louvre::Document document(relabeled->root());
+    const auto reference = document.index_of(relabeled->at({1, 0}).value());
+    massert(reference);
+    massert(document.reference(*reference) ==
+            document.index_of(relabeled->at({0}).value()));
+    massert(document.freeze().reference(*reference) ==
+            document.index_of(relabeled->at({0}).value()));
+
+    const auto replaced_root = v0.replace({}, text("Root"));
+    massert(replaced_root && replaced_root->root()->text());
+
+    return 0;
+}
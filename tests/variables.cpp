@@ -0,0 +1,100 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <iostream>
+#include <louvre/api.hpp>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+const std::string SOURCE = "#center #var(product) #var(version)#end\n"
+                           "Released on #var(date), #var( product ) rocks\n"
+                           "#var(product)\n"
+                           "#paragraph ##var(product) #end";
+
+std::string error_of(const std::string &source) {
+    auto parser = louvre::Parser(source);
+    parser.set_variables({{"a", "b"}});
+    auto parse_res = parser.parse();
+
+    if (auto e = std::get_if<louvre::TagError>(&parse_res)) {
+        return e->message();
+    }
+
+    return "";
+}
+
+int main(void) {
+    const std::string product = "Louvre";
+    const std::string version = "0.1.0";
+
+    auto parser = louvre::Parser(SOURCE);
+    parser.set_variables({{"product", product},
+                          {"version", version},
+                          {"date", "2025-01-01"}});
+    auto parse_res = parser.parse();
+    massert(std::holds_alternative<std::shared_ptr<louvre::Node>>(parse_res));
+
+    auto root = std::get<std::shared_ptr<louvre::Node>>(parse_res);
+    massert(3 == root->children().size());
+
+    auto center = root->children().at(0);
+    massert(1 == center->children().size());
+    massert("Louvre 0.1.0" == center->children().at(0)->text().value());
+
+    // Values merge with the text around them into a single node
+    auto text = root->children().at(1);
+    massert("Released on 2025-01-01, Louvre rocks Louvre" ==
+            text->text().value());
+    massert(SOURCE.find("Released") == text->source_start());
+    massert(SOURCE.find("\n#paragraph") == text->source_end());
+
+    massert("#var(product)" ==
+            root->children().at(2)->children().at(0)->text().value());
+
+    massert("Undefined variable" == error_of("#var(c)"));
+    massert("Expected exactly one argument" == error_of("#var(a, a)"));
+    massert("" == error_of("#var(a)"));
+
+    // Bindings are only called with the tags they are bound to, so they may
+    // rely on their arguments
+    int  calls   = 0;
+    auto article = louvre::Parser("Hello #article(Intro) body #end");
+    article.add_block_tag_binding(
+        "article", [&calls](std::shared_ptr<louvre::Tag> tag) {
+            calls++;
+            return std::make_pair(louvre::ParserAction::AddChildAndBranch,
+                                  louvre::Node(tag->arguments().at(0)));
+        });
+    auto article_res = article.parse();
+    massert(std::holds_alternative<std::shared_ptr<louvre::Node>>(article_res));
+    massert(1 == calls);
+
+    auto intro = std::get<std::shared_ptr<louvre::Node>>(article_res)
+                     ->children()
+                     .at(1);
+    massert("Intro" == std::get<std::string>(intro->type()));
+    massert("body" == intro->children().at(0)->text().value());
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "jobs.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <variant>
+#include <vector>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+namespace fs = std::filesystem;
+
+static void write(const fs::path &path, const std::string &content) {
+    std::ofstream(path) << content;
+}
+
+static bool contains(const std::vector<std::string> &directories,
+                     const fs::path                 &directory) {
+    return directories.end() != std::find(directories.begin(),
+                                          directories.end(),
+                                          directory.string());
+}
+
+int main(void) {
+    const auto root = fs::temp_directory_path() / "louvre-watch-test";
+    fs::remove_all(root);
+    fs::create_directories(root / "doc");
+    fs::create_directories(root / "lib1");
+    fs::create_directories(root / "lib2");
+
+    // The document includes a file that includes a file in another directory
+    write(root / "doc" / "a.lv", "#include(../lib1/b.lv)");
+    write(root / "lib1" / "b.lv", "B #include(../lib2/c.lv)");
+    write(root / "lib2" / "c.lv", "C");
+
+    const auto input = louvre::cli::canonical_path(root / "doc" / "a.lv");
+    const auto format = louvre::cli::Converter::find_format("text");
+    massert(format);
+
+    const louvre::cli::Converter converter(*format, 80);
+    auto res = converter.convert("#include(../lib1/b.lv)", input);
+    massert(std::holds_alternative<louvre::cli::Conversion>(res));
+
+    std::vector<louvre::cli::Job> jobs = {louvre::cli::Job{
+        input,
+        std::nullopt,
+        std::get<louvre::cli::Conversion>(res).mIncludes,
+        false}};
+    const std::vector<std::string> inputs = {input};
+    auto                          &includes = *converter.includes();
+
+    // Directories of nested includes are watched too
+    const auto directories =
+        louvre::cli::watched_directories(input, jobs[0], includes);
+    massert(contains(directories, fs::canonical(root / "doc")));
+    massert(contains(directories, fs::canonical(root / "lib1")));
+    massert(contains(directories, fs::canonical(root / "lib2")));
+
+    // Nothing is stale until a file changes
+    massert(louvre::cli::stale_jobs(jobs, inputs, {}, includes).empty());
+
+    // Writing a nested include makes the job stale, even though the
+    // document does not include it directly
+    const auto nested = fs::canonical(root / "lib2" / "c.lv");
+    write(nested, "Changed");
+    fs::last_write_time(nested,
+                        fs::last_write_time(nested) + std::chrono::seconds(1));
+
+    const std::unordered_set<std::string> changed = {nested.string()};
+    const auto stale = louvre::cli::stale_jobs(jobs, inputs, changed, includes);
+    massert(1 == stale.size() && 0 == stale[0]);
+
+    // Failed jobs are always converted again
+    jobs[0].mFailed = true;
+    massert(1 == louvre::cli::stale_jobs(jobs, inputs, {}, includes).size());
+
+    fs::remove_all(root);
+    return 0;
+}
@@ -0,0 +1,71 @@
+/* Copyright 2025 Alessandro Salerno
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <louvre/width.hpp>
+#include <string>
+
+#define mstr(x) #x
+
+#define massert(expr)                                                \
+    if (!(expr)) {                                                   \
+        std::cerr << "Assertion failed " mstr(expr) "" << std::endl; \
+        return -1;                                                   \
+    }
+
+int main(void) {
+    massert(1 == louvre::codepoint_width(U'a'));
+    massert(0 == louvre::codepoint_width(U'\t'));
+    massert(0 == louvre::codepoint_width(0x7F));
+    massert(1 == louvre::codepoint_width(U'è'));
+    massert(0 == louvre::codepoint_width(0x0301));
+    massert(0 == louvre::codepoint_width(0x200B));
+    massert(2 == louvre::codepoint_width(U'日'));
+    massert(2 == louvre::codepoint_width(0xFF21));
+    massert(2 == louvre::codepoint_width(0x1F600));
+    massert(1 == louvre::codepoint_width(0x110000));
+
+    massert(0 == louvre::display_width(""));
+    massert(5 == louvre::display_width("hello"));
+    massert(26 == louvre::display_width("abcdefghijklmnopqrstuvwxyz"));
+    massert(26 == louvre::display_width("abcdefghijkl\tmnopqrstuvwxyz"));
+    massert(4 == louvre::display_width("日本"));
+    massert(5 == louvre::display_width("cafe\xcc\x81 "));
+    massert(14 == louvre::display_width("louvre \xf0\x9f\x98\x80 日本"));
+    massert(2 == louvre::display_width("\xff\xe6"));
+
+    // The fast path must agree with a codepoint by codepoint sum
+    const char32_t samples[] = {U'a', U' ', U'\n', U'Z', U'è', 0x0301, U'日',
+                                0x1F600};
+    const char    *encoded[] = {"a", " ", "\n", "Z", "è", "\xcc\x81", "日",
+                                "\xf0\x9f\x98\x80"};
+
+    for (int round = 0; round < 1000; round++) {
+        std::string text;
+        std::size_t expected = 0;
+
+        for (int i = 0; i < 64; i++) {
+            // Mostly ASCII, so that most chunks take the fast path
+            const int pick = (rand() % 4) ? rand() % 4 : rand() % 8;
+            text += encoded[pick];
+            expected += louvre::codepoint_width(samples[pick]);
+        }
+
+        massert(expected == louvre::display_width(text));
+    }
+
+    return 0;
+}